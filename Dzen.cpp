@@ -0,0 +1,439 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "Dzen.h"
+#include "Helpers.h"
+#include "Instrumentation.h"
+
+#include <QEvent>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPixmapCache>
+#include <QProcess>
+#include <QWheelEvent>
+#include <QtMath>
+
+#include <climits>
+
+DzenView::DzenView(QWidget *parent) : QWidget(parent)
+, m_head(0)
+, m_compiled(64)
+, m_shaped(256)
+, m_alignment(Qt::AlignLeft|Qt::AlignVCenter)
+, m_margin(0)
+, m_lineHeight(0)
+{
+    // we paint the background of the dirty lines ourselves, no need to repaint the dialog behind them
+    setAutoFillBackground(true);
+    setLineCount(1);
+}
+
+bool DzenView::Segment::operator==(const Segment &other) const
+{
+    return type == other.type && x == other.x && width == other.width && text == other.text &&
+           size == other.size && font == other.font && fg == other.fg && bg == other.bg;
+}
+
+void DzenView::setAlignment(Qt::Alignment alignment)
+{
+    if (m_alignment == alignment)
+        return;
+    m_alignment = alignment;
+    update();
+}
+
+void DzenView::setMargin(int margin)
+{
+    if (m_margin == margin)
+        return;
+    m_margin = margin;
+    updateHint();
+    update();
+}
+
+void DzenView::setLineCount(int count)
+{
+    count = qMax(count, 1);
+    if (count == m_lines.count())
+        return;
+    QVector<Line> lines;
+    for (int row = 0; row < m_lines.count(); ++row)
+        lines << lineAt(row);
+    lines.resize(count);
+    m_lines = lines;
+    m_head = 0;
+    updateHint();
+    update();
+}
+
+QString DzenView::line(int row) const
+{
+    return row < m_lines.count() ? lineAt(row).text : QString();
+}
+
+QStaticText DzenView::shaped(const QString &text, const QFont &font, const QString &fontName)
+{
+    const QString key = fontName + QChar(0x1f) + text;
+    if (const QStaticText *hit = m_shaped.object(key))
+        return *hit;
+    QStaticText *st = new QStaticText(text);
+    st->setTextFormat(Qt::PlainText);
+    st->prepare(QTransform(), font);
+    m_shaped.insert(key, st);
+    return *st;
+}
+
+DzenView::Line DzenView::compile(const QString &text)
+{
+    Line line;
+    line.text = text;
+    QFont font = this->font();
+    QString fontName; // the cache key, empty is the default font
+    QColor fg, bg;
+    QVector<Area> openAreas;
+    int x = 0;
+    QString run;
+
+    auto flush = [&]() {
+        if (run.isEmpty())
+            return;
+        Segment s;
+        s.type = Segment::Text;
+        s.x = x;
+        s.text = run;
+        s.shaped = shaped(run, font, fontName);
+        s.width = qCeil(s.shaped.size().width());
+        s.font = font;
+        s.fg = fg;
+        s.bg = bg;
+        line.segments << s;
+        x += s.width;
+        line.width = qMax(line.width, x);
+        line.height = qMax(line.height, QFontMetrics(font).height());
+        run.clear();
+    };
+
+    for (int i = 0; i < text.length(); ++i) {
+        if (text.at(i) != '^') {
+            run += text.at(i);
+            continue;
+        }
+        if (i + 1 < text.length() && text.at(i+1) == '^') { // ^^ is a literal caret
+            run += '^';
+            ++i;
+            continue;
+        }
+        const int open = text.indexOf('(', i);
+        const int close = open < 0 ? -1 : text.indexOf(')', open);
+        const QString cmd = open < 0 ? QString() : text.mid(i + 1, open - i - 1);
+        if (close < 0 || cmd.isEmpty() || cmd.length() > 2 || !cmd.at(0).isLower() || !cmd.at(cmd.length()-1).isLower()) {
+            // not a command, dzen2 prints those as well
+            run += '^';
+            continue;
+        }
+        flush();
+        const QString arg = text.mid(open + 1, close - open - 1);
+        i = close;
+        if (cmd == "fg") {
+            fg = arg.isEmpty() ? QColor() : QColor(arg.trimmed());
+        } else if (cmd == "bg") {
+            bg = arg.isEmpty() ? QColor() : QColor(arg.trimmed());
+        } else if (cmd == "fn") {
+            fontName = arg.trimmed();
+            font = fontName.isEmpty() ? this->font() : xftFont(fontName);
+        } else if (cmd == "i") {
+            Segment s;
+            s.type = Segment::Icon;
+            s.x = x;
+            s.text = arg;
+            if (!QPixmapCache::find(arg, &s.icon)) {
+                s.icon = QPixmap(arg);
+                QPixmapCache::insert(arg, s.icon);
+            }
+            s.width = s.icon.width();
+            s.size = s.icon.size();
+            s.fg = fg;
+            s.bg = bg;
+            line.segments << s;
+            line.height = qMax(line.height, s.size.height());
+            x += s.width;
+        } else if (cmd == "r" || cmd == "ro") {
+            const int sep = arg.indexOf('x');
+            Segment s;
+            s.type = cmd == "r" ? Segment::Rect : Segment::RectOutline;
+            s.x = x;
+            s.size = QSize(arg.left(sep).toInt(), sep < 0 ? 0 : arg.mid(sep + 1).toInt());
+            s.width = s.size.width();
+            s.fg = fg;
+            s.bg = bg;
+            line.segments << s;
+            line.height = qMax(line.height, s.size.height());
+            x += s.width;
+        } else if (cmd == "pa") { // absolute x position, the y is ignored - we've lines
+            x = arg.section(';', 0, 0).toInt();
+        } else if (cmd == "ca") {
+            if (arg.isEmpty()) {
+                if (!openAreas.isEmpty()) {
+                    Area area = openAreas.takeLast();
+                    area.x1 = x;
+                    line.areas << area;
+                }
+            } else {
+                Area area;
+                area.button = arg.section(',', 0, 0).trimmed().toInt();
+                area.command = arg.section(',', 1).trimmed();
+                area.x0 = area.x1 = x;
+                openAreas << area;
+            }
+        }
+        line.width = qMax(line.width, x);
+    }
+    flush();
+    for (Area &area : openAreas) { // unterminated, extends to the end
+        area.x1 = line.width;
+        line.areas << area;
+    }
+    return line;
+}
+
+DzenView::Line DzenView::compiled(const QString &text)
+{
+    if (const Line *hit = m_compiled.object(text))
+        return *hit;
+    TRACE_SPAN("dzen compile");
+    const Line line = compile(text);
+    m_compiled.insert(text, new Line(line));
+    return line;
+}
+
+void DzenView::setLine(int row, const QString &text)
+{
+    if (row < 0 || row >= m_lines.count())
+        return;
+    Line &line = lineAt(row);
+    if (line.text == text)
+        return; // clocks tend to print the same minute 60 times
+    const Line old = line;
+    line = compiled(text);
+    updateHint();
+
+    QRect dirty = lineRect(row);
+    if (old.width == line.width || !(m_alignment & (Qt::AlignRight|Qt::AlignHCenter))) {
+        // the line stays in place, so only the segments that changed need a repaint
+        // ^pa() can move x back, so those can be anywhere in the line
+        int x0 = INT_MAX, x1 = INT_MIN;
+        auto cover = [&](const Segment &s) {
+            x0 = qMin(x0, s.x);
+            x1 = qMax(x1, s.x + s.width);
+        };
+        const int count = qMax(old.segments.count(), line.segments.count());
+        for (int i = 0; i < count; ++i) {
+            const bool inOld = i < old.segments.count(), inNew = i < line.segments.count();
+            if (inOld && inNew && old.segments.at(i) == line.segments.at(i))
+                continue;
+            if (inOld)
+                cover(old.segments.at(i));
+            if (inNew)
+                cover(line.segments.at(i));
+        }
+        if (x0 >= x1)
+            return;
+        const int x = origin(row);
+        dirty.setLeft(x + x0);
+        dirty.setRight(x + x1 - 1);
+    }
+    update(dirty);
+}
+
+void DzenView::appendLine(const QString &text)
+{
+    if (m_lines.isEmpty())
+        return;
+    // nothing moves in memory, the oldest line just becomes the new bottom one
+    const int last = m_lines.count() - 1;
+    m_head = (m_head + 1) % m_lines.count();
+    lineAt(last) = compiled(text);
+    updateHint();
+    // and on screen the other lines are blitted up, only the new one gets painted
+    if (last > 0 && isVisible())
+        scroll(0, -lineHeight(), QRect(m_margin, top(), width() - 2 * m_margin, m_lines.count() * lineHeight()));
+    update(lineRect(last));
+}
+
+int DzenView::lineHeight() const
+{
+    return m_lineHeight;
+}
+
+int DzenView::top() const
+{
+    const int total = m_lines.count() * lineHeight();
+    if (m_alignment & Qt::AlignTop)
+        return m_margin;
+    if (m_alignment & Qt::AlignBottom)
+        return height() - m_margin - total;
+    return (height() - total) / 2;
+}
+
+QRect DzenView::lineRect(int row) const
+{
+    return QRect(m_margin, top() + row * lineHeight(), width() - 2 * m_margin, lineHeight());
+}
+
+int DzenView::origin(int row) const
+{
+    const QRect r = lineRect(row);
+    const int width = lineAt(row).width;
+    if (m_alignment & Qt::AlignRight)
+        return r.right() - width;
+    if (m_alignment & Qt::AlignHCenter)
+        return r.center().x() - width / 2;
+    return r.x();
+}
+
+QSize DzenView::sizeHint() const
+{
+    return m_hint;
+}
+
+QSize DzenView::minimumSizeHint() const
+{
+    return m_hint; // like a non-wrapping QLabel, that's what lets the window grow along
+}
+
+void DzenView::updateHint()
+{
+    int width = 0, height = fontMetrics().height();
+    for (const Line &line : m_lines) {
+        width = qMax(width, line.width);
+        height = qMax(height, line.height);
+    }
+    // all rows have the height of the tallest one and like the width that only grows
+    if (height > m_lineHeight) {
+        m_lineHeight = height;
+        update(); // every row moved
+    }
+    const QSize hint(width + 2 * m_margin, m_lines.count() * lineHeight() + 2 * m_margin);
+    // only growing requires a relayout, a status bar w/ changing field widths shall not jitter
+    if (hint.width() > m_hint.width() || hint.height() != m_hint.height()) {
+        m_hint = hint.expandedTo(QSize(m_hint.width(), 0));
+        updateGeometry();
+    }
+}
+
+void DzenView::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::FontChange) {
+        // the default font is baked into the compiled lines
+        m_compiled.clear();
+        m_shaped.clear();
+        for (Line &line : m_lines)
+            line = compile(line.text);
+        m_hint = QSize();
+        m_lineHeight = 0;
+        updateHint();
+        update();
+    }
+    QWidget::changeEvent(event);
+}
+
+void DzenView::click(const QPoint &pos, int button)
+{
+    const int row = (pos.y() - top()) / lineHeight();
+    if (pos.y() < top() || row >= m_lines.count())
+        return;
+    const int x = pos.x() - origin(row);
+    // nested areas: the innermost one is closed first, so it's also first in the list
+    for (const Area &area : lineAt(row).areas) {
+        if (area.button == button && x >= area.x0 && x < area.x1) {
+            QProcess::startDetached("/bin/sh", QStringList() << "-c" << area.command);
+            return;
+        }
+    }
+}
+
+void DzenView::mouseReleaseEvent(QMouseEvent *event)
+{
+    // dzen2 numbers the buttons like X11 does
+    int button = 0;
+    switch (event->button()) {
+        case Qt::LeftButton: button = 1; break;
+        case Qt::MiddleButton: button = 2; break;
+        case Qt::RightButton: button = 3; break;
+        default: break;
+    }
+    if (button)
+        click(event->pos(), button);
+    QWidget::mouseReleaseEvent(event);
+}
+
+void DzenView::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    if (delta)
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        click(event->position().toPoint(), delta > 0 ? 4 : 5);
+#else
+        click(event->pos(), delta > 0 ? 4 : 5);
+#endif
+    QWidget::wheelEvent(event);
+}
+
+void DzenView::paintEvent(QPaintEvent *event)
+{
+    QPainter p(this);
+    const QColor defaultFg = palette().color(foregroundRole());
+    for (int row = 0; row < m_lines.count(); ++row) {
+        const QRect r = lineRect(row);
+        if (!event->rect().intersects(r))
+            continue;
+        const int x = origin(row);
+        for (const Segment &s : lineAt(row).segments) {
+            const QRect sr(x + s.x, r.y(), s.width, r.height());
+            if (!event->rect().intersects(sr))
+                continue;
+            if (s.bg.isValid())
+                p.fillRect(sr, s.bg);
+            const QColor fg = s.fg.isValid() ? s.fg : defaultFg;
+            switch (s.type) {
+                case Segment::Text:
+                    p.setFont(s.font);
+                    p.setPen(fg);
+                    p.drawStaticText(sr.x(), sr.y() + (sr.height() - qCeil(s.shaped.size().height())) / 2, s.shaped);
+                    break;
+                case Segment::Icon:
+                    p.drawPixmap(sr.x(), sr.y() + (sr.height() - s.size.height()) / 2, s.icon);
+                    break;
+                case Segment::Rect:
+                case Segment::RectOutline: {
+                    const QRect rect(sr.x(), sr.y() + (sr.height() - s.size.height()) / 2, s.size.width(), s.size.height());
+                    if (s.type == Segment::Rect) {
+                        p.fillRect(rect, fg);
+                    } else {
+                        p.setPen(fg);
+                        p.setBrush(Qt::NoBrush);
+                        p.drawRect(rect.adjusted(0, 0, -1, -1));
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_DZEN_H
+#define QARMA_DZEN_H
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QPixmap>
+#include <QStaticText>
+#include <QVector>
+#include <QWidget>
+
+/*  The title and slave window of --dzen
+    Status bars get updated several times a second, so unlike a QLabel this neither parses
+    rich text nor relayouts on every update: each line is compiled into styled segments
+    and an update only repaints the part of the line that actually changed.
+    Supported dzen2 commands: ^fg() ^bg() ^fn() ^i() ^r() ^ro() ^pa() ^ca() and ^^ for a caret
+    Compiled lines are cached by their content and shaped text runs by font and text, so a
+    status line where one field changes costs one shaped run. */
+class DzenView : public QWidget
+{
+    Q_OBJECT
+public:
+    DzenView(QWidget *parent = nullptr);
+    void setAlignment(Qt::Alignment alignment);
+    void setMargin(int margin);
+    void setLineCount(int count);
+    int lineCount() const { return m_lines.count(); }
+    QString line(int row) const;
+    void setLine(int row, const QString &text);
+    void appendLine(const QString &text); // scrolls the others up, the oldest one drops out
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+protected:
+    void changeEvent(QEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+private:
+    struct Segment {
+        enum Type { Text, Icon, Rect, RectOutline } type;
+        int x, width;
+        QString text; // or the icon path
+        QStaticText shaped;
+        QPixmap icon;
+        QSize size;
+        QFont font;
+        QColor fg, bg; // invalid: the palette
+        bool operator==(const Segment &other) const;
+    };
+    struct Area { // ^ca(), clickable
+        int button, x0, x1;
+        QString command;
+    };
+    struct Line {
+        QString text;
+        QVector<Segment> segments;
+        QVector<Area> areas;
+        int width = 0;
+        int height = 0; // of the tallest font, icon or rect
+    };
+    Line compile(const QString &text);
+    Line compiled(const QString &text);
+    // the lines are a ring buffer, m_head is the index of the top row
+    const Line &lineAt(int row) const { return m_lines.at((m_head + row) % m_lines.count()); }
+    Line &lineAt(int row) { return m_lines[(m_head + row) % m_lines.count()]; }
+    QStaticText shaped(const QString &text, const QFont &font, const QString &fontName);
+    void click(const QPoint &pos, int button);
+    int lineHeight() const;
+    int top() const;
+    QRect lineRect(int row) const;
+    int origin(int row) const;
+    void updateHint();
+    QVector<Line> m_lines;
+    int m_head;
+    QCache<QString, Line> m_compiled;
+    QCache<QString, QStaticText> m_shaped;
+    Qt::Alignment m_alignment;
+    int m_margin;
+    QSize m_hint;
+    int m_lineHeight;
+};
+
+#endif //QARMA_DZEN_H
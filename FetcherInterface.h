@@ -0,0 +1,50 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FETCHERINTERFACE_H
+#define FETCHERINTERFACE_H
+
+#include <QtPlugin>
+#include <QByteArray>
+
+#include <functional>
+
+class QIODevice;
+class QObject;
+class QUrl;
+
+/*  --text-info --url downloads through a plugin, so only processes that actually fetch
+    something pay for loading QtNetwork.
+    The replies are plain QIODevices: they emit readyRead() while the body arrives and
+    readChannelFinished() at the end, the rest goes through the fetcher. */
+class FetcherInterface
+{
+public:
+    virtual ~FetcherInterface() {}
+    virtual QIODevice *get(const QUrl &url, QObject *parent) = 0; // follows redirects unless they're less safe
+    virtual QByteArray contentType(const QIODevice *reply) const = 0; // the header, once the reply has one
+    virtual bool failed(const QIODevice *reply) const = 0; // for other reasons than abort(), see errorString()
+    virtual void abort(QIODevice *reply) = 0; // drops the connection, nothing is read after that
+    // received and total bytes as they arrive, total is -1 while unknown. Disconnects when context goes away
+    virtual void onProgress(QIODevice *reply, QObject *context, const std::function<void(qint64, qint64)> &progress) = 0;
+};
+
+#define FetcherInterface_iid "org.qarma.FetcherInterface/1.0"
+Q_DECLARE_INTERFACE(FetcherInterface, FetcherInterface_iid)
+
+#endif //FETCHERINTERFACE_H
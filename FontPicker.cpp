@@ -0,0 +1,274 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "FontPicker.h"
+#include "Instrumentation.h"
+
+#include <QAbstractListModel>
+#include <QBoxLayout>
+#include <QComboBox>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QSaveFile>
+#include <QSpinBox>
+#include <QStandardPaths>
+#include <QVector>
+
+// QFontDatabase only has static members since Qt6 and no instance is needed anymore
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#define FONT_DATABASE QFontDatabase::
+#else
+#define FONT_DATABASE QFontDatabase().
+#endif
+
+struct FontFamily {
+    QString name;
+    quint8 types;
+};
+
+static QDataStream &operator<<(QDataStream &s, const FontFamily &f) { return s << f.name << f.types; }
+static QDataStream &operator>>(QDataStream &s, FontFamily &f) { return s >> f.name >> f.types; }
+
+// fontconfig rewrites its caches whenever fonts are installed or removed
+// the newest mtime and the number of caches per directory, removing a cache doesn't make anything newer
+static QByteArray fontconfigStamp()
+{
+    QCryptographicHash stamp(QCryptographicHash::Sha1);
+    const QStringList dirs = QStringList()
+        << QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/fontconfig"
+        << "/var/cache/fontconfig" << "/usr/lib/fontconfig/cache" << "/usr/local/var/cache/fontconfig";
+    for (const QString &path : dirs) {
+        const QFileInfo dir(path);
+        if (!dir.exists())
+            continue;
+        qint64 newest = dir.lastModified().toMSecsSinceEpoch();
+        const QFileInfoList caches = QDir(path).entryInfoList(QStringList() << "*.cache*", QDir::Files);
+        for (const QFileInfo &cache : caches)
+            newest = qMax(newest, cache.lastModified().toMSecsSinceEpoch());
+        QByteArray fields;
+        QDataStream s(&fields, QIODevice::WriteOnly);
+        s << path << newest << qint64(caches.count());
+        stamp.addData(fields);
+    }
+    return stamp.result();
+}
+
+static QVector<FontFamily> fontFamilies()
+{
+    TRACE_SPAN("font families");
+    static const quint32 magic = 0x71666332; // "qfc2"
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) +
+                         QLatin1String("/qarma/fonts");
+    const QByteArray stamp = fontconfigStamp();
+    QVector<FontFamily> families;
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream s(&file);
+        quint32 m; QByteArray st;
+        s >> m >> st;
+        if (m == magic && st == stamp) {
+            s >> families;
+            if (s.status() == QDataStream::Ok)
+                return families;
+        }
+        families.clear();
+        file.close();
+    }
+
+    // that's the expensive part, every query populates the family
+    const QStringList names = FONT_DATABASE families();
+    families.reserve(names.count());
+    for (const QString &name : names) {
+        if (FONT_DATABASE isPrivateFamily(name))
+            continue;
+        FontFamily f;
+        f.name = name;
+        f.types = FONT_DATABASE isSmoothlyScalable(name) ? FontPicker::Vector : FontPicker::Bitmap;
+        f.types |= FONT_DATABASE isFixedPitch(name) ? FontPicker::Fixed : FontPicker::Variable;
+        families << f;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile out(path);
+    if (out.open(QIODevice::WriteOnly)) {
+        QDataStream s(&out);
+        s << magic << stamp << families;
+        out.commit();
+    }
+    return families;
+}
+
+// hands the (filtered) families out in batches as the view asks for more
+class FontModel : public QAbstractListModel
+{
+public:
+    FontModel(const QVector<FontFamily> &families, int types, QObject *parent)
+        : QAbstractListModel(parent), m_families(families), m_types(types), m_loaded(0) { setFilter(QString()); }
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : m_loaded;
+    }
+    QVariant data(const QModelIndex &index, int role) const override {
+        if (!index.isValid() || index.row() >= m_loaded)
+            return QVariant();
+        const QString &name = m_families.at(m_visible.at(index.row())).name;
+        if (role == Qt::DisplayRole)
+            return name;
+        if (role == Qt::FontRole) // only asked for the rows that get painted
+            return QFont(name);
+        return QVariant();
+    }
+    bool canFetchMore(const QModelIndex &parent) const override {
+        return !parent.isValid() && m_loaded < m_visible.count();
+    }
+    void fetchMore(const QModelIndex &parent) override {
+        if (parent.isValid())
+            return;
+        const int count = qMin(256, m_visible.count() - m_loaded);
+        beginInsertRows(QModelIndex(), m_loaded, m_loaded + count - 1);
+        m_loaded += count;
+        endInsertRows();
+    }
+    void setFilter(const QString &filter) {
+        beginResetModel();
+        m_visible.clear();
+        for (int i = 0; i < m_families.count(); ++i) {
+            const FontFamily &f = m_families.at(i);
+            // the --type flags work like QFontDialog's: within a pair, none means both
+            if ((m_types & (FontPicker::Vector|FontPicker::Bitmap)) && !(f.types & m_types & (FontPicker::Vector|FontPicker::Bitmap)))
+                continue;
+            if ((m_types & (FontPicker::Fixed|FontPicker::Variable)) && !(f.types & m_types & (FontPicker::Fixed|FontPicker::Variable)))
+                continue;
+            if (!filter.isEmpty() && !f.name.contains(filter, Qt::CaseInsensitive))
+                continue;
+            m_visible << i;
+        }
+        m_loaded = 0;
+        endResetModel();
+    }
+    QModelIndex find(const QString &family) {
+        for (int row = 0; row < m_visible.count(); ++row) {
+            if (m_families.at(m_visible.at(row)).name.compare(family, Qt::CaseInsensitive))
+                continue;
+            while (m_loaded <= row)
+                fetchMore(QModelIndex());
+            return index(row);
+        }
+        return QModelIndex();
+    }
+private:
+    QVector<FontFamily> m_families;
+    QVector<int> m_visible;
+    int m_types, m_loaded;
+};
+
+FontPicker::FontPicker(int types, QWidget *parent) : QDialog(parent)
+{
+    QVBoxLayout *vl = new QVBoxLayout(this);
+    vl->addWidget(m_filter = new QLineEdit(this));
+    m_filter->setPlaceholderText(tr("Search font family"));
+    m_filter->setClearButtonEnabled(true);
+
+    vl->addWidget(m_families = new QListView(this));
+    m_families->setUniformItemSizes(true); // otherwise the view asks every row for its font to figure its size
+    m_model = new FontModel(fontFamilies(), types, this);
+    m_families->setModel(m_model);
+
+    QHBoxLayout *hl = new QHBoxLayout;
+    vl->addLayout(hl);
+    hl->addWidget(new QLabel(tr("Style"), this));
+    hl->addWidget(m_styles = new QComboBox(this), 1);
+    hl->addWidget(new QLabel(tr("Size"), this));
+    hl->addWidget(m_size = new QSpinBox(this));
+    m_size->setRange(1, 512);
+    m_size->setValue(qMax(1, font().pointSize()));
+
+    vl->addWidget(m_sample = new QLineEdit(this));
+    m_sample->setMinimumHeight(64);
+
+    QDialogButtonBox *btns = new QDialogButtonBox(QDialogButtonBox::Ok|QDialogButtonBox::Cancel, Qt::Horizontal, this);
+    vl->addWidget(btns);
+    connect(btns, SIGNAL(accepted()), this, SLOT(accept()));
+    connect(btns, SIGNAL(rejected()), this, SLOT(reject()));
+
+    connect(m_filter, &QLineEdit::textChanged, this, [=](const QString &filter) {
+        const QString family = m_families->currentIndex().data().toString();
+        m_model->setFilter(filter);
+        selectFamily(family);
+    });
+    connect(m_families->selectionModel(), &QItemSelectionModel::currentChanged, this, [=]() { familyChanged(); });
+    connect(m_styles, &QComboBox::currentTextChanged, this, [=]() { updateSample(); });
+    connect(m_size, QOverload<int>::of(&QSpinBox::valueChanged), this, [=]() { updateSample(); });
+
+    selectFamily(font().family());
+    resize(480, 480);
+}
+
+void FontPicker::setSampleText(const QString &text)
+{
+    m_sample->setText(text);
+}
+
+QFont FontPicker::selectedFont() const
+{
+    const QString family = m_families->currentIndex().data().toString();
+    if (family.isEmpty())
+        return font();
+    QFont fnt = FONT_DATABASE font(family, m_styles->currentText(), m_size->value());
+    fnt.setPointSize(m_size->value());
+    return fnt;
+}
+
+void FontPicker::selectFamily(const QString &family)
+{
+    QModelIndex idx = m_model->find(family);
+    if (!idx.isValid() && m_model->canFetchMore(QModelIndex()))
+        m_model->fetchMore(QModelIndex());
+    if (!idx.isValid())
+        idx = m_model->index(0);
+    m_families->setCurrentIndex(idx);
+    m_families->scrollTo(idx, QAbstractItemView::PositionAtCenter);
+}
+
+void FontPicker::familyChanged()
+{
+    const QString family = m_families->currentIndex().data().toString();
+    const QString style = m_styles->currentText();
+    m_styles->blockSignals(true);
+    m_styles->clear();
+    if (!family.isEmpty())
+        m_styles->addItems(FONT_DATABASE styles(family));
+    const int idx = m_styles->findText(style);
+    m_styles->setCurrentIndex(qMax(0, idx));
+    m_styles->blockSignals(false);
+    updateSample();
+}
+
+void FontPicker::updateSample()
+{
+    m_sample->setFont(selectedFont());
+}
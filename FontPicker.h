@@ -0,0 +1,55 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_FONTPICKER_H
+#define QARMA_FONTPICKER_H
+
+#include <QDialog>
+#include <QFont>
+
+class FontModel;
+class QComboBox;
+class QLineEdit;
+class QListView;
+class QSpinBox;
+
+/*  A QFontDialog asks QFontDatabase about every style and size of every family before it shows,
+    that's seconds with a few thousand fonts. This one lists the families from a cache that's
+    only rebuilt when fontconfig's caches change, the model hands them out in batches as the
+    view scrolls, the view renders the previews for the visible rows only and the styles
+    are looked up for the selected family only. */
+class FontPicker : public QDialog
+{
+    Q_OBJECT
+public:
+    enum Type { Vector = 1, Bitmap = 2, Fixed = 4, Variable = 8 };
+    FontPicker(int types = 0, QWidget *parent = nullptr);
+    void setSampleText(const QString &text);
+    QFont selectedFont() const;
+private:
+    void selectFamily(const QString &family);
+    void familyChanged();
+    void updateSample();
+    FontModel *m_model;
+    QLineEdit *m_filter, *m_sample;
+    QListView *m_families;
+    QComboBox *m_styles;
+    QSpinBox *m_size;
+};
+
+#endif //QARMA_FONTPICKER_H
@@ -0,0 +1,685 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "Helpers.h"
+#include "Instrumentation.h"
+#include "ListSorter.h"
+
+#include <QCalendarWidget>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QCryptographicHash>
+#include <QDate>
+#include <QFile>
+#include <QFileInfo>
+#include <QFont>
+#include <QHash>
+#include <QImageReader>
+#include <QLineEdit>
+#include <QLocale>
+#include <QPixmap>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTextEdit>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QUrl>
+
+#include <cstdio>
+#include <cstring>
+
+#define IF_IS(_TYPE_) if (const _TYPE_ *t = qobject_cast<const _TYPE_*>(w))
+
+QString value(const QWidget *w, const QString &pattern)
+{
+    if (!w)
+        return QString();
+
+    IF_IS(QLineEdit) {
+        return t->text();
+    } else IF_IS(QTreeWidget) {
+        QString s;
+        foreach (QTreeWidgetItem *item, t->selectedItems()) {
+            for (int i = 0; i < t->columnCount(); ++i)
+                s += item->text(i);
+        }
+        return s;
+    } else IF_IS(QComboBox) {
+        return t->currentText();
+    } else IF_IS(QCalendarWidget) {
+        if (pattern.isNull())
+            return QLocale::system().toString(t->selectedDate(), QLocale::ShortFormat);
+        return t->selectedDate().toString(pattern);
+    } else IF_IS(QCheckBox) {
+        return t->isChecked() ? "true" : "false";
+    }
+    return QString();
+}
+
+QPixmap thumbnail(const QString &path, uint size)
+{
+    TRACE_SPAN("thumbnail");
+    size = qMin(size, 1024u);
+    QImage thumb;
+    QImageReader thumbReader;
+    thumbReader.setFileName(path);
+    if (!thumbReader.canRead())
+        return QPixmap();
+
+    thumbReader.setQuality(50);
+    QSize sz = thumbReader.size();
+    QSize origSz = sz;
+    bool skipThumbnail = sz.width()*sz.height() < 1920*1200+1;
+
+    if (skipThumbnail) {
+        sz.scale(QSize(size,size), Qt::KeepAspectRatio);
+        thumbReader.setScaledSize(sz);
+    } else {
+        QFileInfo info(path);
+        QString canonicalPath = info.canonicalFilePath();
+        if (canonicalPath.isEmpty())
+            canonicalPath = info.absoluteFilePath();
+        QUrl url = QUrl::fromLocalFile(canonicalPath);
+        QCryptographicHash md5(QCryptographicHash::Md5);
+        md5.addData(QFile::encodeName(url.adjusted(QUrl::RemovePassword).url()));
+
+        QString folder;
+        uint tSize;
+        if (size <= 128) {
+            tSize = 128; folder = "normal/";
+        } else if (size <= 256) {
+            tSize = 256; folder = "large/";
+        } else if (size <= 512) {
+            tSize = 512; folder = "x-large/";
+        } else {
+            tSize = 1024; folder = "xx-large/";
+        }
+        Q_UNUSED(tSize);
+
+        const QString thumbPath = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) +
+                                                                    QLatin1String("/thumbnails/") + folder +
+                                                                    QString::fromLatin1(md5.result().toHex()) + QStringLiteral(".png");
+        QFileInfo tInfo(thumbPath);
+        if (tInfo.exists() && info.metadataChangeTime() <= tInfo.lastModified() && info.lastModified() <= tInfo.lastModified()) {
+            thumbReader.setFileName(thumbPath);
+            sz.scale(QSize(size,size), Qt::KeepAspectRatio);
+            thumbReader.setScaledSize(sz);
+            if (thumbReader.read(&thumb)) {
+                int w = thumb.text("Thumb::Image::Width").toInt();
+                int h = thumb.text("Thumb::Image::Height").toInt();
+                if (origSz == QSize(w, h))
+                    return QPixmap::fromImage(thumb);
+            }
+        }
+        thumbReader.setFileName(path);
+//        sz.scale(QSize(tSize,tSize), Qt::KeepAspectRatio); // in case we'll ever store the thumbnail
+        sz.scale(QSize(size,size), Qt::KeepAspectRatio);
+        thumbReader.setScaledSize(sz);
+    }
+    if (!thumbReader.read(&thumb))
+        return QPixmap();
+//    if (skipThumbnail)
+        return QPixmap::fromImage(thumb);
+}
+
+static void setupItem(QTreeWidgetItem *item, bool editable, bool checkable, bool icons)
+{
+    // the original order, for whatever wants to restore or print it
+    static int serial = 0;
+    item->setData(0, Qt::UserRole, serial++);
+    Qt::ItemFlags flags = item->flags();
+    if (editable)
+        flags |= Qt::ItemIsEditable;
+    if (checkable) {
+        flags |= Qt::ItemIsUserCheckable;
+        item->setCheckState(0, QVariant(item->text(0)).toBool() ? Qt::Checked : Qt::Unchecked);
+    }
+    if (icons)
+        item->setIcon(0, QPixmap(item->text(0)));
+    if (checkable || icons) {
+        item->setData(0, Qt::EditRole, item->text(0));
+        item->setText(0, QString());
+    }
+    item->setFlags(flags);
+}
+
+QTreeWidgetItem *addItem(QTreeWidget *tw, const QStringList &cells, bool editable, bool checkable, bool icons)
+{
+    QTreeWidgetItem *item = new QTreeWidgetItem(tw, cells);
+    setupItem(item, editable, checkable, icons);
+    return item;
+}
+
+QTreeWidgetItem *addItem(QTreeWidgetItem *parent, const QStringList &cells, bool editable, bool checkable, bool icons)
+{
+    QTreeWidgetItem *item = new QTreeWidgetItem(parent, cells);
+    setupItem(item, editable, checkable, icons);
+    return item;
+}
+
+void addItems(QTreeWidget *tw, QStringList &values, bool editable, bool checkable, bool icons)
+{
+    for (int i = 0; i < values.count(); ) {
+        QStringList itemValues;
+        for (int j = 0; j < tw->columnCount(); ++j) {
+            itemValues << values.at(i++);
+            if (i == values.count())
+                break;
+        }
+        addItem(tw, itemValues, editable, checkable, icons);
+    }
+}
+
+qint64 addItems(QTreeWidget *tw, const char *data, qint64 size, bool nul, bool flush, bool editable, bool checkable, bool icons)
+{
+    TRACE_SPAN("add raw items");
+    const int columns = qMax(1, tw->columnCount());
+    const char *c = data, *end = data + size, *consumed = data;
+    QList<QTreeWidgetItem*> items;
+    QTreeWidgetItem *item = nullptr;
+    int column = 0;
+    while (c < end) {
+        const char *eor = static_cast<const char*>(memchr(c, nul ? '\0' : '\n', end - c));
+        if (!eor) {
+            if (!flush)
+                break;
+            eor = end;
+        }
+        if (!item)
+            item = new QTreeWidgetItem;
+        if (nul) { // one cell per record, like the arguments
+            item->setText(column++, QString::fromLocal8Bit(c, eor - c));
+        } else { // one row per line, the last column takes whatever tabs are left
+            for (const char *cell = c; column < columns; ) {
+                const char *tab = column + 1 < columns ? static_cast<const char*>(memchr(cell, '\t', eor - cell)) : nullptr;
+                item->setText(column++, unescaped(cell, tab ? tab : eor));
+                if (!tab)
+                    break;
+                cell = tab + 1;
+            }
+            column = columns;
+        }
+        c = eor + 1;
+        if (column == columns || (flush && c >= end)) {
+            setupItem(item, editable, checkable, icons);
+            items << item;
+            item = nullptr;
+            column = 0;
+            consumed = qMin(c, end);
+        }
+    }
+    delete item; // incomplete, it'll be parsed again once the rest arrived
+    tw->addTopLevelItems(items);
+    return consumed - data;
+}
+
+// whitespace separated, "quoted" and \escaped like a shell would
+static QStringList commandArgs(const QString &line)
+{
+    QStringList args;
+    QString arg;
+    bool quoted = false, inArg = false;
+    for (int i = 0; i < line.length(); ++i) {
+        const QChar c = line.at(i);
+        if (c == '\\' && i + 1 < line.length()) {
+            arg += line.at(++i);
+            inArg = true;
+        } else if (c == '"') {
+            quoted = !quoted;
+            inArg = true;
+        } else if (c.isSpace() && !quoted) {
+            if (inArg)
+                args << arg;
+            arg.clear();
+            inArg = false;
+        } else {
+            arg += c;
+            inArg = true;
+        }
+    }
+    if (inArg)
+        args << arg;
+    return args;
+}
+
+static void setCell(QTreeWidgetItem *item, int column, const QString &value, bool checkable, bool icons)
+{
+    if (column > 0 || !(checkable || icons)) {
+        item->setText(column, value);
+        return;
+    }
+    if (checkable)
+        item->setCheckState(0, QVariant(value).toBool() ? Qt::Checked : Qt::Unchecked);
+    if (icons)
+        item->setIcon(0, QPixmap(value));
+    item->setData(0, Qt::EditRole, value);
+    item->setText(0, QString());
+}
+
+// key -> row of the list it's attached to, like ListSorter and ListTree
+class ListRows : public QObject
+{
+public:
+    ListRows(QTreeWidget *tw) : QObject(tw) { setObjectName("qarma_list_rows"); }
+    static QHash<QString, QTreeWidgetItem*> &of(QTreeWidget *tw) {
+        ListRows *rows = static_cast<ListRows*>(tw->findChild<QObject*>("qarma_list_rows", Qt::FindDirectChildrenOnly));
+        return (rows ? rows : new ListRows(tw))->m_rows;
+    }
+private:
+    QHash<QString, QTreeWidgetItem*> m_rows;
+};
+
+qint64 listCommands(QTreeWidget *tw, const char *data, qint64 size, bool flush, bool editable, bool checkable, bool icons)
+{
+    TRACE_SPAN("list commands");
+    QHash<QString, QTreeWidgetItem*> &rows = ListRows::of(tw);
+    // a sorted list stays sorted
+    ListSorter *sorter = tw->findChild<ListSorter*>();
+    const char *c = data, *end = data + size;
+    while (c < end) {
+        const char *eol = static_cast<const char*>(memchr(c, '\n', end - c));
+        if (!eol) {
+            if (!flush)
+                break;
+            eol = end;
+        }
+        QStringList args = commandArgs(QString::fromLocal8Bit(c, eol - c));
+        c = eol + 1;
+        if (args.isEmpty())
+            continue;
+        const QString command = args.takeFirst();
+        if (command == "clear") {
+            tw->clear();
+            rows.clear();
+            continue;
+        }
+        if (args.isEmpty() || (command != "add" && command != "update" && command != "remove")) {
+            qWarning("cannot handle list command \"%s\"", qPrintable(command));
+            continue;
+        }
+        const QString key = args.takeFirst();
+        QTreeWidgetItem *item = rows.value(key);
+        if (command == "remove") {
+            delete rows.take(key);
+        } else if (command == "add") {
+            if (!item) {
+                item = addItem(tw, args, editable, checkable, icons);
+                rows.insert(key, item);
+                if (sorter)
+                    sorter->place(item);
+                continue;
+            }
+            // adding an existing key replaces its cells, but keeps the row as it is
+            for (int i = 0; i < args.count() && i < tw->columnCount(); ++i)
+                setCell(item, i, args.at(i), checkable, icons);
+            if (sorter)
+                sorter->place(item);
+        } else if (!item) {
+            qWarning("cannot update unknown row \"%s\"", qPrintable(key));
+        } else {
+            for (const QString &assignment : args) {
+                const int eq = assignment.indexOf('=');
+                const QString name = assignment.left(eq);
+                bool ok;
+                int column = name.toInt(&ok) - 1;
+                if (!ok) { // or the header
+                    for (column = tw->columnCount() - 1; column > -1; --column) {
+                        if (tw->headerItem()->text(column) == name)
+                            break;
+                    }
+                }
+                if (eq < 0 || column < 0 || column >= tw->columnCount()) {
+                    qWarning("cannot update \"%s\" of row \"%s\"", qPrintable(assignment), qPrintable(key));
+                    continue;
+                }
+                setCell(item, column, assignment.mid(eq + 1), checkable, icons);
+            }
+            if (sorter)
+                sorter->place(item);
+        }
+    }
+    return qMin(c, end) - data;
+}
+
+void buildList(QTreeWidget **tree, QStringList &values, QStringList &columns, bool &showHeader)
+{
+    QTreeWidget *tw = *tree;
+
+    if (!tw)
+        return;
+
+    int columnCount = columns.count();
+    tw->setHeaderHidden(!showHeader);
+    if (columns.count()) {
+        tw->setColumnCount(columns.count());
+        tw->setHeaderLabels(columns);
+    } else {
+        columnCount = 1;
+    }
+
+
+    for (int i = 0; i < values.count(); ) {
+        QStringList itemValues;
+        for (int j = 0; j < columnCount; ++j) {
+            itemValues << values.at(i++);
+            if (i == values.count())
+                break;
+        }
+        tw->addTopLevelItem(new QTreeWidgetItem(tw, itemValues));
+    }
+
+    for (int i = 0; i < columns.count(); ++i)
+        tw->resizeColumnToContents(i);
+
+    values.clear();
+    columns.clear();
+    showHeader = false;
+    *tree = NULL;
+}
+
+QFont xftFont(const QString &pattern)
+{
+    QFont font;
+    if (pattern.isEmpty())
+        return font;
+    /*
+    plausible subset of https://keithp.com/~keithp/render/Xft.tutorial 
+    <family>-<size>:<name>=<value>...
+    */
+    const QStringList fields = pattern.split(':');
+    bool ok = false;
+    int size = -1;
+    const int split = fields.at(0).lastIndexOf('-');
+    if (split > 0) size = fields.at(0).mid(split + 1).toUInt(&ok);
+    font = ok ? QFont(fields.at(0).mid(0, split), size) : QFont(fields.at(0));
+    
+    for (int i = 1; i < fields.count(); ++i) {
+        if (fields.at(i) == "light") font.setWeight(QFont::Light);
+        else if (fields.at(i) == "medium") font.setWeight(QFont::Medium);
+        else if (fields.at(i) == "demibold") font.setWeight(QFont::DemiBold);
+        else if (fields.at(i) == "bold") font.setWeight(QFont::Bold);
+        else if (fields.at(i) == "black") font.setWeight(QFont::Black);
+        else if (fields.at(i) == "roman") font.setItalic(false);
+        else if (fields.at(i) == "italic") font.setItalic(true);
+        else if (fields.at(i) == "oblique") font.setItalic(true);
+        else if (fields.at(i).contains('=')) {
+            QStringList field = fields.at(i).split('=');
+            if (field.count() < 2) continue;
+            if (field.at(0) == "family") font.setFamily(field.at(1));
+            else if (field.at(0) == "weight") font.setWeight(QFont::Weight(field.at(1).toUInt()));
+            else if (field.at(0) == "size") font.setPointSizeF(field.at(1).toFloat());
+            else if (field.at(0) == "pixelsize") font.setPixelSize(field.at(1).toUInt());
+            else if (field.at(0) == "slant") {
+                if (field.at(0) == "italic" || field.at(0) == "oblique")
+                    font.setItalic(true);
+            }
+        }
+    }
+    return font;
+}
+
+static bool startsAt(const QString &s, int i, const char *needle)
+{
+    for (; *needle; ++needle, ++i) {
+        if (i >= s.size() || s.at(i) != QLatin1Char(*needle))
+            return false;
+    }
+    return true;
+}
+
+static QString pangoWeight(const QString &w)
+{
+    static const char *names[] = { "thin", "100", "ultralight", "200", "light", "300", "book", "380",
+                                   "normal", "400", "medium", "500", "semibold", "600", "bold", "700",
+                                   "ultrabold", "800", "heavy", "900", "ultraheavy", "1000", nullptr };
+    for (int i = 0; names[i]; i += 2) {
+        if (w == QLatin1String(names[i]))
+            return QLatin1String(names[i+1]);
+    }
+    return w;
+}
+
+static QString pangoSize(const QString &size)
+{
+    bool ok;
+    const uint v = size.toUInt(&ok);
+    if (ok) // pango units, 1024th of a point
+        return QString::number(v/1024.0) + "pt";
+    return size;
+}
+
+// the value ends up in a quoted css declaration inside a quoted html attribute, nothing may get out of either
+static QString cssSafe(const QString &value)
+{
+    QString r;
+    r.reserve(value.size());
+    for (const QChar c : value) {
+        if (c != '"' && c != '\'' && c != ';' && c != '\\' && c != '<' && c != '>' && c != '&' &&
+            c != '{' && c != '}' && c != ':' && !c.isNull() && c.category() != QChar::Other_Control)
+            r += c;
+    }
+    return r;
+}
+
+// the closing '>' of a tag, ignoring those in quoted attribute values
+static int tagEnd(const QString &s, int from)
+{
+    QChar quote;
+    for (int i = from; i < s.size(); ++i) {
+        const QChar c = s.at(i);
+        if (!quote.isNull()) {
+            if (c == quote)
+                quote = QChar();
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// translate the attributes of a pango <span> tag into a QTextDocument compatible style
+// https://docs.gtk.org/Pango/pango_markup.html#the-span-attributes
+static QString spanStyle(const QString &s, int from, int to)
+{
+    QString style, decoration;
+    int i = from;
+    while (i < to) {
+        while (i < to && s.at(i).isSpace())
+            ++i;
+        int eq = s.indexOf('=', i);
+        if (eq < 0 || eq >= to)
+            break;
+        const QString name = s.mid(i, eq - i).trimmed();
+        i = eq + 1;
+        while (i < to && s.at(i).isSpace())
+            ++i;
+        if (i >= to)
+            break;
+        QChar quote = s.at(i);
+        int end;
+        if (quote == '"' || quote == '\'') {
+            end = s.indexOf(quote, ++i);
+            if (end < 0 || end > to)
+                end = to;
+        } else {
+            end = i;
+            while (end < to && !s.at(end).isSpace())
+                ++end;
+        }
+        const QString value = cssSafe(s.mid(i, end - i));
+        i = end + 1;
+
+        if (name == "foreground" || name == "fgcolor" || name == "color") {
+            style += "color:" + value + ';';
+        } else if (name == "background" || name == "bgcolor") {
+            style += "background-color:" + value + ';';
+        } else if (name == "font_family" || name == "face") {
+            style += "font-family:'" + value + "';";
+        } else if (name == "size" || name == "font_size") {
+            style += "font-size:" + pangoSize(value) + ';';
+        } else if (name == "style" || name == "font_style") {
+            style += "font-style:" + value + ';';
+        } else if (name == "weight" || name == "font_weight") {
+            style += "font-weight:" + pangoWeight(value) + ';';
+        } else if (name == "variant" || name == "font_variant") {
+            if (value == "smallcaps" || value == "small-caps")
+                style += "font-variant:small-caps;";
+        } else if (name == "font" || name == "font_desc") {
+            // "[FAMILY-LIST] [STYLE-OPTIONS] [SIZE]" - good enough for "Sans Bold Italic 12"
+            QStringList family;
+            foreach (const QString &token, value.split(' ', SKIP_EMPTY)) {
+                const QString t = token.toLower();
+                bool isSize;
+                token.toDouble(&isSize);
+                if (isSize)
+                    style += "font-size:" + token + "pt;";
+                else if (t == "italic" || t == "oblique")
+                    style += "font-style:" + t + ';';
+                else if (pangoWeight(t) != t)
+                    style += "font-weight:" + pangoWeight(t) + ';';
+                else
+                    family << token;
+            }
+            if (!family.isEmpty())
+                style += "font-family:'" + family.join(' ') + "';";
+        } else if (name == "underline") {
+            if (value != "none")
+                decoration += " underline";
+        } else if (name == "strikethrough") {
+            if (value == "true")
+                decoration += " line-through";
+        }
+    }
+    if (!decoration.isEmpty())
+        style += "text-decoration:" + decoration.mid(1) + ';';
+    return style;
+}
+
+QString pangoToRichText(const QString &s, bool escapes)
+{
+    // zenity uses pango markup, https://docs.gtk.org/Pango/pango_markup.html
+    // This near-html-subset isn't really compatible w/ Qt's html subset and we end up
+    // w/ a weird mix of ASCII escape codes and html tags
+    // the below is NOT a perfect translation
+
+    // known "caveats"
+    // pango termiantes the string for "\0" (we do not - atm)
+    // pango inserts some control char for "\f", but that's not reasonably handled by gtk label (so it's ignored here)
+
+    QString r;
+    r.reserve(s.size());
+    for (int i = 0; i < s.size(); ++i) {
+        const QChar c = s.at(i);
+        if (c == '\\' && escapes) {
+            if (++i == s.size())
+                break;
+            const QChar e = s.at(i);
+            if (e == '\\') {
+                r += e;
+            } else if (e == 'n' || e == 'r') {
+                r += "<br>";
+            } else if (e == 't') {
+                r += "&nbsp;&nbsp;&nbsp;";
+            } else if (e >= '0' && e <= '9') { // octal
+                int sz = 1;
+                while (sz < 3 && i + sz < s.size() && s.at(i+sz) >= '0' && s.at(i+sz) <= '9')
+                    ++sz;
+                r += QChar(s.mid(i, sz).toUInt(nullptr, 8));
+                i += sz - 1;
+            } else {
+                --i; // unknown escape, the backslash is dropped and the character kept
+            }
+            continue;
+        }
+        if (c == '<' && startsAt(s, i, "<span") && i + 5 < s.size() && (s.at(i+5).isSpace() || s.at(i+5) == '>')) {
+            const int end = tagEnd(s, i + 5);
+            if (end > -1) {
+                const QString style = spanStyle(s, i + 5, end);
+                r += style.isEmpty() ? QString("<span>") : "<span style=\"" + style + "\">";
+                i = end;
+                continue;
+            }
+        }
+        r += c;
+    }
+    return r;
+}
+
+QByteArray mapInput(const QString &path, QFile *file)
+{
+    const bool opened = path == "-" ? file->open(stdin, QIODevice::ReadOnly)
+                                    : (file->setFileName(path), file->open(QIODevice::ReadOnly));
+    if (!opened)
+        return QByteArray();
+    // pipes and ttys can't be mapped (nor can empty files)
+    if (const qint64 size = file->size()) {
+        if (uchar *data = file->map(0, size))
+            return QByteArray::fromRawData(reinterpret_cast<const char*>(data), size);
+    }
+    QByteArray data = file->readAll();
+    if (data.isNull())
+        data = QByteArray("");
+    return data;
+}
+
+QString unescaped(const char *begin, const char *end)
+{
+    if (!memchr(begin, '\\', end - begin))
+        return QString::fromLocal8Bit(begin, end - begin);
+    QByteArray r;
+    r.reserve(end - begin);
+    for (const char *c = begin; c < end; ++c) {
+        if (*c != '\\' || c + 1 == end) {
+            r += *c;
+            continue;
+        }
+        switch (*++c) {
+            case 'n': r += '\n'; break;
+            case 't': r += '\t'; break;
+            default: r += *c; break;
+        }
+    }
+    return QString::fromLocal8Bit(r);
+}
+
+QStringList inputLines(QString text)
+{
+    if (text.endsWith('\n'))
+        text.resize(text.length()-1);
+    return text.split('\n');
+}
+
+int progressValue(const QString &line)
+{
+    static const QRegularExpression nondigit("[^0-9]");
+    bool ok;
+    const int u = line.section(nondigit,0,0).toInt(&ok);
+    return ok ? qMin(100,u) : -1;
+}
+
+void appendText(QTextEdit *te, const QString &text)
+{
+    TRACE_SPAN("set text");
+    if (te->property("qarma_html").toBool())
+        te->setHtml(te->toHtml() + text);
+    else
+        te->setPlainText(te->toPlainText() + text);
+}
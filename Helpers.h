@@ -0,0 +1,61 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_HELPERS_H
+#define QARMA_HELPERS_H
+
+// the parsing and rendering helpers of the dialogs, kept free of any Qarma state
+
+class QFile;
+class QFont;
+class QPixmap;
+class QTextEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QWidget;
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
+    #define SKIP_EMPTY Qt::SkipEmptyParts
+#else
+    #define SKIP_EMPTY QString::SkipEmptyParts
+#endif
+
+QString pangoToRichText(const QString &s, bool escapes); // escapes: interpret \n, \t etc. like zenity
+QString value(const QWidget *w, const QString &pattern);
+QPixmap thumbnail(const QString &path, uint size);
+QTreeWidgetItem *addItem(QTreeWidget *tw, const QStringList &cells, bool editable, bool checkable, bool icons);
+QTreeWidgetItem *addItem(QTreeWidgetItem *parent, const QStringList &cells, bool editable, bool checkable, bool icons);
+void addItems(QTreeWidget *tw, QStringList &values, bool editable, bool checkable, bool icons);
+// NUL terminated cells or lines of tab separated cells, returns the consumed size - w/o flush the rest is an incomplete row
+qint64 addItems(QTreeWidget *tw, const char *data, qint64 size, bool nul, bool flush, bool editable, bool checkable, bool icons);
+// "add KEY cells…", "update KEY column=value…", "remove KEY" and "clear" - one per line, returns the consumed size
+qint64 listCommands(QTreeWidget *tw, const char *data, qint64 size, bool flush, bool editable, bool checkable, bool icons);
+void buildList(QTreeWidget **tree, QStringList &values, QStringList &columns, bool &showHeader);
+QFont xftFont(const QString &pattern);
+QByteArray mapInput(const QString &path, QFile *file); // path "-" is stdin, the data is valid as long as the file is open
+QString unescaped(const char *begin, const char *end); // local 8 bit, with \n, \t and \\ resolved
+// the stdin parsers of the dialogs
+QStringList inputLines(QString text); // w/o the final newline
+int progressValue(const QString &line); // the leading percentage, capped at 100 - or -1
+void appendText(QTextEdit *te, const QString &text); // honors the qarma_html property
+
+#endif //QARMA_HELPERS_H
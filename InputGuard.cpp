@@ -0,0 +1,138 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "InputGuard.h"
+#include "Instrumentation.h"
+
+#include <QApplication>
+#include <QEvent>
+#include <QPalette>
+#include <QWidget>
+
+#if QT_VERSION >= 0x050000
+#include <QWindow>
+#endif
+
+#ifdef WS_X11
+#include <xcb/xcb.h>
+#endif
+
+InputGuard *InputGuard::s_instance = nullptr;
+
+void InputGuard::watch(QWidget *w)
+{
+#if QT_VERSION >= 0x050000
+    if (qApp->platformName() == "wayland")
+        return;
+#endif
+    if (!s_instance) {
+        s_instance = new InputGuard;
+#ifdef WS_X11
+        if (qApp->platformName() == "xcb")
+            qApp->installNativeEventFilter(s_instance);
+#endif
+    }
+    w->installEventFilter(s_instance);
+}
+
+#ifdef WS_X11
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+bool InputGuard::nativeEventFilter(const QByteArray &type, void *message, qintptr *)
+#else
+bool InputGuard::nativeEventFilter(const QByteArray &type, void *message, long *)
+#endif
+{
+    if (!m_guardedWidget || type != "xcb_generic_event_t")
+        return false;
+    const xcb_generic_event_t *ev = static_cast<xcb_generic_event_t*>(message);
+    if ((ev->response_type & ~0x80) != XCB_FOCUS_IN)
+        return false;
+    // Qt drops the focus changes caused by grabs, but FocusIn/NotifyUngrab is exactly what we're after:
+    // the grab that kept us from getting ours is gone. While we hold the grab, nobody else can get one.
+    const xcb_focus_in_event_t *fe = reinterpret_cast<const xcb_focus_in_event_t*>(ev);
+    if (fe->mode == XCB_NOTIFY_MODE_UNGRAB && fe->event == m_guardedWidget->window()->winId()) {
+        // not from within the event dispatch, check() grabs and that's a roundtrip
+        QMetaObject::invokeMethod(this, [this]() { if (m_guardedWidget) check(m_guardedWidget); }, Qt::QueuedConnection);
+    }
+    return false;
+}
+#endif
+
+bool InputGuard::eventFilter(QObject *o, QEvent *e)
+{
+    QWidget *w = static_cast<QWidget*>(o);
+    switch (e->type()) {
+        case QEvent::FocusIn:
+        case QEvent::WindowActivate:
+            if (hasActiveFocus(w)) {
+                // the time to focus, ie. when the user can start typing
+                static bool focused = false;
+                if (!focused) {
+                    focused = true;
+                    Trace::instant("keyboard focus");
+                }
+                guard(w);
+            }
+            break;
+        case QEvent::FocusOut:
+        case QEvent::WindowDeactivate:
+            if (w == m_guardedWidget && !hasActiveFocus(w))
+                unguard(w);
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+bool InputGuard::check(QWidget *w)
+{
+#if QT_VERSION >= 0x050000
+    // try to re-grab
+    if (!w->window()->windowHandle()->setKeyboardGrabEnabled(true))
+        w->releaseKeyboard();
+#endif
+    if (w == QWidget::keyboardGrabber()) {
+        w->setPalette(QPalette());
+        return true;
+    }
+    w->setPalette(QPalette(Qt::white, Qt::red, Qt::white, Qt::black, Qt::gray,
+                           Qt::white, Qt::white, Qt::red, Qt::red));
+    return false;
+}
+
+void InputGuard::guard(QWidget *w)
+{
+    Trace::instant("keyboard grab");
+    w->grabKeyboard();
+    // even if that failed, we'll learn about the other grab going away and try again
+    m_guardedWidget = w;
+    check(w);
+}
+
+bool InputGuard::hasActiveFocus(QWidget *w)
+{
+    return w == QApplication::focusWidget() && w->isActiveWindow();
+}
+
+void InputGuard::unguard(QWidget *w)
+{
+    Q_ASSERT(m_guardedWidget == w);
+    m_guardedWidget = nullptr;
+    w->releaseKeyboard();
+}
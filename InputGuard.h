@@ -0,0 +1,59 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_INPUTGUARD_H
+#define QARMA_INPUTGUARD_H
+
+#include <QObject>
+
+#ifdef WS_X11
+#include <QAbstractNativeEventFilter>
+#endif
+
+class QWidget;
+
+/*  Grabs the keyboard while a password entry has the focus and paints it red if some other
+    client holds the grab, ie. might be listening in.
+    Nothing polls here: Qt tells us about focus and activation and X11 about foreign grabs going away */
+class InputGuard : public QObject
+#ifdef WS_X11
+                 , public QAbstractNativeEventFilter
+#endif
+{
+public:
+    InputGuard() : QObject(), m_guardedWidget(nullptr) {}
+    static void watch(QWidget *w);
+#ifdef WS_X11
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    bool nativeEventFilter(const QByteArray &type, void *message, qintptr *) override;
+#else
+    bool nativeEventFilter(const QByteArray &type, void *message, long *) override;
+#endif
+#endif
+protected:
+    bool eventFilter(QObject *o, QEvent *e) override;
+private:
+    bool check(QWidget *w);
+    void guard(QWidget *w);
+    bool hasActiveFocus(QWidget *w);
+    void unguard(QWidget *w);
+    QWidget *m_guardedWidget;
+    static InputGuard *s_instance;
+};
+
+#endif //QARMA_INPUTGUARD_H
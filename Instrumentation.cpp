@@ -0,0 +1,276 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "Instrumentation.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+bool Trace::s_tracking = false;
+bool Trace::s_recording = false;
+std::atomic<const char*> Trace::s_phase(nullptr);
+QVector<const char*> Trace::s_enclosing;
+QString Trace::s_path;
+QElapsedTimer Trace::s_clock;
+QVector<Trace::Event> Trace::s_events;
+
+void Trace::start(const QString &path)
+{
+    s_path = path;
+    s_events.reserve(1024);
+    trackPhases();
+    s_recording = true;
+}
+
+void Trace::trackPhases()
+{
+    if (!s_clock.isValid())
+        s_clock.start();
+    s_tracking = true;
+}
+
+void Trace::record(const char *name, char phase, qint64 ts, qint64 dur)
+{
+    if (!s_recording)
+        return;
+    Event e = { name, phase, ts, dur };
+    s_events.append(e);
+}
+
+bool Trace::write()
+{
+    if (!s_recording)
+        return false;
+    QFile file(s_path);
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate)) {
+        qWarning("Cannot write trace to %s", qPrintable(s_path));
+        return false;
+    }
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (int i = 0; i < s_events.count(); ++i) {
+        const Event &e = s_events.at(i);
+        json += "{\"name\":\"" + QByteArray(e.name) + "\",\"cat\":\"qarma\",\"ph\":\"" + e.phase +
+                "\",\"pid\":" + pid + ",\"tid\":1,\"ts\":" + QByteArray::number(e.ts);
+        if (e.phase == 'X')
+            json += ",\"dur\":" + QByteArray::number(e.dur);
+        else if (e.phase == 'i')
+            json += ",\"s\":\"p\"";
+        json += (i < s_events.count() - 1) ? "},\n" : "}\n";
+    }
+    json += "]}\n";
+    file.write(json);
+    return true;
+}
+
+bool Stats::s_enabled = false;
+QString Stats::s_path;
+QElapsedTimer Stats::s_clock;
+QElapsedTimer Stats::s_pendingSince;
+qint64 Stats::s_bytes = 0;
+qint64 Stats::s_lines = 0;
+qint64 Stats::s_applied = 0;
+qint64 Stats::s_coalesced = 0;
+qint64 Stats::s_pending = 0;
+qint64 Stats::s_maxLatency = 0;
+qint64 Stats::s_dbusCalls = 0;
+qint64 Stats::s_timers = 0;
+QHash<QByteArray, qint64> Stats::s_timerReceivers;
+
+void Stats::start(const QString &path)
+{
+    s_path = path;
+    s_clock.start();
+    s_enabled = true;
+}
+
+void Stats::update(int count)
+{
+    if (!s_enabled || count < 1)
+        return;
+    if (!s_pending)
+        s_pendingSince.start();
+    s_pending += count;
+}
+
+void Stats::painted()
+{
+    if (!s_enabled || !s_pending)
+        return;
+    ++s_applied;
+    s_coalesced += s_pending - 1;
+    s_pending = 0;
+    s_maxLatency = qMax(s_maxLatency, s_pendingSince.nsecsElapsed() / 1000);
+}
+
+void Stats::timerEvent(const QObject *receiver)
+{
+    if (!s_enabled)
+        return;
+    ++s_timers;
+    ++s_timerReceivers[QByteArray(receiver->metaObject()->className())];
+}
+
+void Stats::dump()
+{
+    if (!s_enabled)
+        return;
+    qint64 peakRss = -1;
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage))
+        peakRss = usage.ru_maxrss; // kB on linux
+#endif
+    QString report = QString("qarma statistics after %1 s\n").arg(s_clock.elapsed() / 1000.0, 0, 'f', 1);
+    report += QString("  input bytes:                %1\n").arg(s_bytes);
+    report += QString("  input lines:                %1\n").arg(s_lines);
+    report += QString("  updates applied:            %1\n").arg(s_applied);
+    report += QString("  updates coalesced:          %1\n").arg(s_coalesced);
+    report += QString("  updates pending:            %1\n").arg(s_pending);
+    report += QString("  max input-to-paint latency: %1 ms\n").arg(s_maxLatency / 1000.0, 0, 'f', 1);
+    report += QString("  peak RSS:                   %1 kB\n").arg(peakRss);
+    report += QString("  D-Bus calls:                %1\n").arg(s_dbusCalls);
+    const double seconds = qMax<qint64>(s_clock.elapsed(), 1) / 1000.0;
+    report += QString("  timer wakeups:              %1 (%2/s)\n").arg(s_timers).arg(s_timers / seconds, 0, 'f', 2);
+    for (QHash<QByteArray, qint64>::const_iterator it = s_timerReceivers.constBegin(); it != s_timerReceivers.constEnd(); ++it)
+        report += QString("    %1 %2\n").arg(QString::fromLatin1(it.key() + ':'), -24).arg(it.value());
+
+    if (s_path.isEmpty()) {
+        fprintf(stderr, "%s", qPrintable(report));
+        return;
+    }
+    QFile file(s_path);
+    if (file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+        file.write(report.toLocal8Bit());
+    else
+        qWarning("Cannot write statistics to %s", qPrintable(s_path));
+}
+
+Watchdog *Watchdog::s_instance = nullptr;
+
+Watchdog::Watchdog(int threshold) : QThread()
+, m_threshold(threshold)
+, m_pong(0)
+, m_nextStall(0)
+{
+    m_clock.start();
+}
+
+void Watchdog::start(int threshold)
+{
+    if (s_instance)
+        return;
+    Trace::trackPhases();
+    s_instance = new Watchdog(qMax(threshold, 10));
+    s_instance->QThread::start(QThread::LowPriority);
+}
+
+void Watchdog::stop()
+{
+    if (!s_instance)
+        return;
+    s_instance->requestInterruption();
+    s_instance->wait();
+}
+
+void Watchdog::run()
+{
+    const int interval = qMax(5, m_threshold / 4);
+    while (!isInterruptionRequested()) {
+        const qint64 ping = m_clock.elapsed();
+        m_pong = -1;
+        QMetaObject::invokeMethod(qApp, [this]() { m_pong = m_clock.elapsed(); }, Qt::QueuedConnection);
+        const char *phase = nullptr;
+        bool stalled = false;
+        while (m_pong < 0 && !isInterruptionRequested()) {
+            msleep(interval);
+            if (!stalled && m_clock.elapsed() - ping > m_threshold) {
+                stalled = true;
+                phase = Trace::phase(); // whatever the GUI thread is stuck in right now
+            }
+        }
+        if (stalled && m_pong > -1) {
+            Stall stall = { ping, m_pong - ping, phase };
+            qWarning("GUI thread stalled for %lld ms in %s", stall.duration, phase ? phase : "the event loop");
+            QMutexLocker locker(&m_mutex);
+            if (m_stalls.count() < 16)
+                m_stalls.append(stall);
+            else
+                m_stalls[m_nextStall] = stall;
+            m_nextStall = (m_nextStall + 1) % 16;
+        }
+        msleep(interval);
+    }
+}
+
+void Watchdog::dump()
+{
+    if (!s_instance)
+        return;
+    QMutexLocker locker(&s_instance->m_mutex);
+    const QVector<Stall> &stalls = s_instance->m_stalls;
+    fprintf(stderr, "qarma watchdog, last %d stalls beyond %d ms\n", int(stalls.count()), s_instance->m_threshold);
+    // the oldest entry is the next one to be overwritten
+    const int first = stalls.count() < 16 ? 0 : s_instance->m_nextStall;
+    for (int i = 0; i < stalls.count(); ++i) {
+        const Stall &stall = stalls.at((first + i) % stalls.count());
+        fprintf(stderr, "  at %8.3f s: %6lld ms in %s\n", stall.when / 1000.0, stall.duration,
+                                                          stall.phase ? stall.phase : "the event loop");
+    }
+}
+
+#ifdef Q_OS_UNIX
+static int gs_signalFd[2] = { -1, -1 };
+
+static void dumpOnSignal(int)
+{
+    char c = 1;
+    if (::write(gs_signalFd[0], &c, 1) < 0)
+        return; // nothing sane to do from a signal handler
+}
+#endif
+
+void listenForDumpSignal()
+{
+#ifdef Q_OS_UNIX
+    if (!(Stats::enabled() || Watchdog::enabled()) || ::socketpair(AF_UNIX, SOCK_STREAM, 0, gs_signalFd))
+        return;
+    // the signal handler only pokes the socket, the dump happens in the event loop
+    QSocketNotifier *snr = new QSocketNotifier(gs_signalFd[1], QSocketNotifier::Read, qApp);
+    QObject::connect(snr, &QSocketNotifier::activated, [=]() {
+        char c;
+        if (::read(gs_signalFd[1], &c, 1) > 0) {
+            Stats::dump();
+            Watchdog::dump();
+        }
+    });
+    struct sigaction sa;
+    sa.sa_handler = dumpOnSignal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, nullptr);
+#endif
+}
@@ -0,0 +1,131 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_INSTRUMENTATION_H
+#define QARMA_INSTRUMENTATION_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+/*  Chrome trace-event recorder, see
+    https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h9I0nSsKchNAySU
+    Load the written file in chrome://tracing or https://ui.perfetto.dev
+    Everything is a no-op (besides a bool check) unless --trace was passed.
+    The watchdog only needs to know the current phase, so that can be tracked w/o recording. */
+class Trace
+{
+public:
+    static void start(const QString &path);
+    static void trackPhases();
+    static bool write();
+    static inline bool enabled() { return s_recording; }
+    static const char *phase() { return s_phase.load(std::memory_order_relaxed); }
+    static qint64 now() { return s_clock.nsecsElapsed() / 1000; }
+    // begin/end nest like the spans do, the enclosing phase is back once a nested one ended
+    static void begin(const char *name) { if (s_tracking) { s_enclosing.append(s_phase.exchange(name)); record(name, 'B', now(), 0); } }
+    static void end(const char *name) { if (s_tracking) { s_phase = s_enclosing.isEmpty() ? nullptr : s_enclosing.takeLast(); record(name, 'E', now(), 0); } }
+    static void instant(const char *name) { if (s_recording) record(name, 'i', now(), 0); }
+    class Span {
+    public:
+        Span(const char *name) : m_name(s_tracking ? name : nullptr)
+                               , m_previous(m_name ? s_phase.exchange(name) : nullptr)
+                               , m_begin(m_name ? now() : 0) {}
+        ~Span() { if (m_name) { s_phase = m_previous; record(m_name, 'X', m_begin, now() - m_begin); } }
+    private:
+        const char *m_name, *m_previous;
+        qint64 m_begin;
+    };
+private:
+    struct Event {
+        const char *name;
+        char phase;
+        qint64 ts, dur;
+    };
+    static void record(const char *name, char phase, qint64 ts, qint64 dur);
+    static bool s_tracking, s_recording;
+    static std::atomic<const char*> s_phase;
+    static QVector<const char*> s_enclosing; // the phases begin() replaced
+    static QString s_path;
+    static QElapsedTimer s_clock;
+    static QVector<Event> s_events;
+};
+
+#define TRACE_SPAN(_NAME_) Trace::Span _trace_span_(_NAME_)
+
+/*  Counters for long running streaming dialogs, dumped when the event loop
+    returns and on SIGUSR1 - to stderr or the file passed as --stats=FILE
+    An "update" is an input that will show up on screen, updates that arrive
+    before the next repaint get coalesced into it.
+    Timer wakeups are counted per receiving class, an idle dialog should have none. */
+class Stats
+{
+public:
+    static void start(const QString &path);
+    static void dump();
+    static inline bool enabled() { return s_enabled; }
+    static void input(const QByteArray &ba) { if (s_enabled) { s_bytes += ba.size(); s_lines += ba.count('\n'); } }
+    static void update(int count = 1);
+    static void painted();
+    static void dbusCall() { if (s_enabled) ++s_dbusCalls; }
+    static void timerEvent(const QObject *receiver);
+private:
+    static bool s_enabled;
+    static QString s_path;
+    static QElapsedTimer s_clock, s_pendingSince;
+    static qint64 s_bytes, s_lines, s_applied, s_coalesced, s_pending, s_maxLatency, s_dbusCalls, s_timers;
+    static QHash<QByteArray, qint64> s_timerReceivers;
+};
+
+/*  Pings the event loop from a thread and logs every round trip that takes
+    longer than the threshold, along with the phase the GUI thread was stuck in.
+    The last stalls are kept and dumped on SIGUSR1. */
+class Watchdog : public QThread
+{
+public:
+    static void start(int threshold);
+    static void stop();
+    static void dump();
+    static inline bool enabled() { return s_instance != nullptr; }
+protected:
+    void run() override;
+private:
+    Watchdog(int threshold);
+    struct Stall {
+        qint64 when, duration;
+        const char *phase;
+    };
+    int m_threshold;
+    QElapsedTimer m_clock;
+    std::atomic<qint64> m_pong;
+    QMutex m_mutex;
+    QVector<Stall> m_stalls; // ring buffer
+    int m_nextStall;
+    static Watchdog *s_instance;
+};
+
+// SIGUSR1 dumps the statistics and the last watchdog stalls, requires the application object
+void listenForDumpSignal();
+
+#endif //QARMA_INSTRUMENTATION_H
@@ -0,0 +1,172 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ListSorter.h"
+#include "Instrumentation.h"
+
+#include <QCollator>
+#include <QHeaderView>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+ListSorter::ListSorter(QTreeWidget *tw, bool numeric) : QObject(tw), m_list(tw), m_numeric(numeric), m_sorting(false)
+, m_column(-1), m_order(Qt::AscendingOrder)
+{
+    tw->header()->setSectionsClickable(true);
+    tw->header()->setSortIndicatorShown(true);
+    tw->header()->setSortIndicator(-1, Qt::AscendingOrder);
+    connect(tw->header(), &QHeaderView::sectionClicked, this, [=](int column) {
+        sort(column, column == m_column && m_order == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder);
+    });
+    // new, removed or edited rows, the keys are recollated with the next sort
+    auto invalidate = [=]() { if (!m_sorting) m_keys.clear(); };
+    connect(tw->model(), &QAbstractItemModel::rowsInserted, this, invalidate);
+    connect(tw->model(), &QAbstractItemModel::rowsRemoved, this, invalidate);
+    connect(tw->model(), &QAbstractItemModel::dataChanged, this, invalidate);
+    connect(tw->model(), &QAbstractItemModel::modelReset, this, invalidate);
+}
+
+ListSorter::Key ListSorter::key(QTreeWidgetItem *item, int column, const QCollator &collator) const
+{
+    const QString text = item->text(column);
+    double number = 0.0;
+    if (column == 0 && (item->flags() & Qt::ItemIsUserCheckable)) {
+        number = item->checkState(0);
+    } else if (m_numeric) {
+        bool ok;
+        number = text.toDouble(&ok);
+        if (!ok) // words after numbers
+            number = std::numeric_limits<double>::infinity();
+    }
+    return Key{item, item->data(0, Qt::UserRole).toInt(), number, collator.sortKey(text)};
+}
+
+// equal keys stay in the original order, either way
+bool ListSorter::before(const Key &a, const Key &b, bool descending)
+{
+    const Key &x = descending ? b : a, &y = descending ? a : b;
+    if (x.number != y.number)
+        return x.number < y.number;
+    if (const int cmp = x.text.compare(y.text))
+        return cmp < 0;
+    return a.serial < b.serial;
+}
+
+const std::vector<ListSorter::Key> &ListSorter::keys(int column)
+{
+    QHash<int, std::vector<Key>>::iterator it = m_keys.find(column);
+    if (it != m_keys.end())
+        return *it;
+    TRACE_SPAN("collate column");
+    QCollator collator;
+    std::vector<Key> &keys = m_keys[column];
+    const int count = m_list->topLevelItemCount();
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
+        keys.push_back(key(m_list->topLevelItem(i), column, collator));
+    return keys;
+}
+
+void ListSorter::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= m_list->columnCount())
+        return;
+    TRACE_SPAN("sort list");
+    const std::vector<Key> &k = keys(column);
+    const int count = int(k.size());
+    std::vector<int> index(count);
+    for (int i = 0; i < count; ++i)
+        index[i] = i;
+    const bool descending = order == Qt::DescendingOrder;
+    auto less = [&k, descending](int a, int b) { return before(k[a], k[b], descending); };
+
+    // sort slices in parallel and merge them - not worth the threads for small lists
+    const int threads = count < 1<<16 ? 1 : qBound(1, int(std::thread::hardware_concurrency()), 16);
+    const int slice = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back([&index, &less, t, slice, count]() {
+            std::sort(index.begin() + qMin(count, t * slice), index.begin() + qMin(count, (t + 1) * slice), less);
+        });
+    }
+    std::sort(index.begin(), index.begin() + qMin(count, slice), less);
+    for (std::thread &worker : workers)
+        worker.join();
+    for (int width = slice; width < count; width *= 2) {
+        for (int lo = 0; lo + width < count; lo += 2 * width)
+            std::inplace_merge(index.begin() + lo, index.begin() + lo + width, index.begin() + qMin(count, lo + 2 * width), less);
+    }
+
+    QList<QTreeWidgetItem*> items;
+    items.reserve(count);
+    for (int i : index)
+        items << k[i].item;
+
+    // taking the items out drops their selection
+    QTreeWidgetItem *current = m_list->currentItem();
+    const QList<QTreeWidgetItem*> selected = m_list->selectedItems();
+    m_sorting = true;
+    m_list->setUpdatesEnabled(false);
+    m_list->invisibleRootItem()->takeChildren();
+    m_list->addTopLevelItems(items);
+    for (QTreeWidgetItem *item : selected)
+        item->setSelected(true);
+    if (current) {
+        m_list->setCurrentItem(current, 0, QItemSelectionModel::NoUpdate);
+        m_list->scrollToItem(current);
+    }
+    m_list->setUpdatesEnabled(true);
+    m_sorting = false;
+
+    m_column = column;
+    m_order = order;
+    m_list->header()->setSortIndicator(column, order);
+}
+
+void ListSorter::place(QTreeWidgetItem *item)
+{
+    const int from = m_list->indexOfTopLevelItem(item);
+    if (!isSorted() || from < 0)
+        return;
+    // a binary search over the other rows, that's a few collations instead of resorting the list
+    QCollator collator;
+    const Key k = key(item, m_column, collator);
+    const bool descending = m_order == Qt::DescendingOrder;
+    int lo = 0, hi = m_list->topLevelItemCount() - 1;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (before(key(m_list->topLevelItem(mid < from ? mid : mid + 1), m_column, collator), k, descending))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == from)
+        return;
+    // taking the item out drops its selection
+    const bool selected = item->isSelected();
+    const bool current = m_list->currentItem() == item;
+    m_list->takeTopLevelItem(from);
+    m_list->insertTopLevelItem(lo, item);
+    item->setSelected(selected);
+    if (current)
+        m_list->setCurrentItem(item, 0, QItemSelectionModel::NoUpdate);
+}
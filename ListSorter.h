@@ -0,0 +1,60 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_LISTSORTER_H
+#define QARMA_LISTSORTER_H
+
+#include <QCollatorSortKey>
+#include <QHash>
+#include <QObject>
+
+#include <vector>
+
+class QCollator;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/*  Sorts a --list when a header is clicked. QTreeWidget's own sorting compares the strings
+    on every comparison, this collates every cell of a column once, keeps those keys until
+    the list changes and sorts an index over them - across all cores for large lists. */
+class ListSorter : public QObject
+{
+    Q_OBJECT
+public:
+    ListSorter(QTreeWidget *tw, bool numeric);
+    void sort(int column, Qt::SortOrder order);
+    bool isSorted() const { return m_column > -1; }
+    void place(QTreeWidgetItem *item); // moves a new or changed top level row to where the sort order wants it
+private:
+    struct Key {
+        QTreeWidgetItem *item;
+        int serial;
+        double number;
+        QCollatorSortKey text;
+    };
+    Key key(QTreeWidgetItem *item, int column, const QCollator &collator) const;
+    static bool before(const Key &a, const Key &b, bool descending);
+    const std::vector<Key> &keys(int column);
+    QTreeWidget *m_list;
+    QHash<int, std::vector<Key>> m_keys;
+    bool m_numeric, m_sorting;
+    int m_column;
+    Qt::SortOrder m_order;
+};
+
+#endif //QARMA_LISTSORTER_H
@@ -0,0 +1,118 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ListTree.h"
+#include "Helpers.h"
+#include "Instrumentation.h"
+
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVariant>
+
+ListTree::ListTree(QTreeWidget *tw, bool editable, bool checkable, bool icons) : QObject(tw), m_list(tw)
+, m_stride(tw->columnCount() + 2), m_editable(editable), m_checkable(checkable), m_icons(icons)
+{
+    tw->setRootIsDecorated(true);
+    connect(tw, &QTreeWidget::itemExpanded, this, [=](QTreeWidgetItem *item) { expand(item); });
+}
+
+void ListTree::addRows(const QStringList &values)
+{
+    TRACE_SPAN("add tree rows");
+    m_cells.reserve(m_cells.count() + values.count() + m_stride);
+    m_cells << values;
+    // an incomplete last row is padded
+    while (m_cells.count() % m_stride)
+        m_cells << QString();
+    const int rows = m_cells.count() / m_stride;
+    for (int row = rows - (values.count() + m_stride - 1) / m_stride; row < rows; ++row) {
+        const QString &parentKey = m_cells.at(row * m_stride + 1);
+        m_rows.insert(m_cells.at(row * m_stride), row);
+        m_children[parentKey] << row;
+        if (parentKey.isEmpty()) {
+            createItem(nullptr, row);
+        } else if (m_expanded.contains(parentKey)) {
+            createItem(m_items.value(parentKey), row);
+        } else if (QTreeWidgetItem *parent = m_items.value(parentKey)) {
+            parent->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        }
+        if (m_checkable && QVariant(m_cells.at(row * m_stride + 2)).toBool())
+            m_pendingChecked << row;
+    }
+    // the ancestors of a checked row might only show up with a later read
+    const QVector<int> pending = m_pendingChecked;
+    m_pendingChecked.clear();
+    for (int row : pending) {
+        if (!materialize(row))
+            m_pendingChecked << row;
+    }
+}
+
+// the item of the row, its ancestors are expanded as far as their rows are known
+QTreeWidgetItem *ListTree::materialize(int row)
+{
+    QVector<int> path;
+    for (int r = row; ; ) {
+        if (m_items.contains(m_cells.at(r * m_stride)))
+            break;
+        path << r;
+        const QString &parentKey = m_cells.at(r * m_stride + 1);
+        if (parentKey.isEmpty())
+            break;
+        r = m_rows.value(parentKey, -1);
+        if (r < 0 || path.count() > m_rows.count()) // unknown parent - or a cycle
+            return nullptr;
+    }
+    // top down, expanding a node makes all its children
+    for (int i = path.count() - 1; i > -1; --i) {
+        const QString &parentKey = m_cells.at(path.at(i) * m_stride + 1);
+        if (parentKey.isEmpty())
+            createItem(nullptr, path.at(i));
+        else if (QTreeWidgetItem *parent = m_items.value(parentKey))
+            expand(parent);
+    }
+    return m_items.value(m_cells.at(row * m_stride));
+}
+
+QTreeWidgetItem *ListTree::createItem(QTreeWidgetItem *parent, int row)
+{
+    const QString &key = m_cells.at(row * m_stride);
+    const QStringList cells = m_cells.mid(row * m_stride + 2, m_stride - 2);
+    QTreeWidgetItem *item = parent ? addItem(parent, cells, m_editable, m_checkable, m_icons)
+                                   : addItem(m_list, cells, m_editable, m_checkable, m_icons);
+    m_items.insert(key, item);
+    item->setData(0, Qt::UserRole, row); // the original order, not the order of expansion
+    item->setData(0, Qt::UserRole + 1, key);
+    // it's only known whether there are children, they're not made before the item gets expanded
+    if (m_children.contains(key))
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    return item;
+}
+
+void ListTree::expand(QTreeWidgetItem *item)
+{
+    const QString key = item->data(0, Qt::UserRole + 1).toString();
+    if (m_expanded.contains(key))
+        return;
+    TRACE_SPAN("expand tree node");
+    m_expanded.insert(key);
+    const QVector<int> rows = m_children.value(key);
+    for (int row : rows)
+        createItem(item, row);
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
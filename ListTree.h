@@ -0,0 +1,57 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_LISTTREE_H
+#define QARMA_LISTTREE_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/*  --list --tree, every row starts with its key and the key of its parent (empty for the top level).
+    The rows are only kept as strings, items are made for the top level and for the children of
+    expanded nodes - so a huge hierarchy costs what's been opened, not what's in it.
+    Checked rows are the exception, they're part of the result and made along with their ancestors.
+    The serial of an item is its row, no matter when it was made. */
+class ListTree : public QObject
+{
+    Q_OBJECT
+public:
+    ListTree(QTreeWidget *tw, bool editable, bool checkable, bool icons);
+    void addRows(const QStringList &values);
+private:
+    QTreeWidgetItem *createItem(QTreeWidgetItem *parent, int row);
+    QTreeWidgetItem *materialize(int row);
+    void expand(QTreeWidgetItem *item);
+    QTreeWidget *m_list;
+    QStringList m_cells; // the rows, m_stride cells each
+    int m_stride;
+    QHash<QString, int> m_rows; // key -> row
+    QHash<QString, QVector<int>> m_children; // parent key -> rows
+    QVector<int> m_pendingChecked; // checked rows w/o the row of some ancestor (yet)
+    QHash<QString, QTreeWidgetItem*> m_items; // key -> item, if there's one yet
+    QSet<QString> m_expanded;
+    bool m_editable, m_checkable, m_icons;
+};
+
+#endif //QARMA_LISTTREE_H
@@ -0,0 +1,43 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef NOTIFIERINTERFACE_H
+#define NOTIFIERINTERFACE_H
+
+#include <QtPlugin>
+#include <QString>
+#include <QVariantMap>
+
+/*  Notification backends live in plugins, so only processes that actually send
+    a notification pay for loading QtDBus & friends.
+    The object() emits sent() for every call on the bus and idle() once there's
+    nothing left to deliver. */
+class NotifierInterface
+{
+public:
+    virtual ~NotifierInterface() {}
+    virtual bool isAvailable() = 0; // whether there's a notification service at all
+    virtual bool busy() const = 0;
+    virtual void notify(const QString &summary, const QString &body, const QVariantMap &hints, int timeout) = 0;
+    virtual QObject *object() = 0;
+};
+
+#define NotifierInterface_iid "org.qarma.NotifierInterface/1.0"
+Q_DECLARE_INTERFACE(NotifierInterface, NotifierInterface_iid)
+
+#endif //NOTIFIERINTERFACE_H
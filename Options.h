@@ -0,0 +1,399 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_OPTIONS_H
+#define QARMA_OPTIONS_H
+
+/*  One table per --help-<category>, also used to parse the arguments of the matching
+    dialog and to tell unknown ones. The help texts are translated when printed. */
+
+#include <QtGlobal>
+
+#define HELP(_TEXT_) QT_TRANSLATE_NOOP("Qarma", _TEXT_)
+
+enum class Opt {
+    Unhandled, Title, WindowIcon, Width, Height, Pos, Timeout, OkLabel, CancelLabel, Modal, Popup, Attach,
+    Class, Name, Text, Day, Month, Year, DateFormat, EntryText, HideText, Values, Int, Float,
+    IconName, NoWrap, NoMarkup, Ellipsize, SelectableLabels, Filename, Multiple, Directory, Save,
+    Separator, ConfirmOverwrite, FileFilter, PreviewImages, Column, Checklist, Radiolist, Imagelist,
+    Editable, PrintColumn, HideColumn, HideHeader, MidSearch, Listen, Hint, Percentage, Pulsate,
+    AutoClose, AutoKill, NoCancel, TimeRemaining, DefaultCancel, Value, MinValue, MaxValue, Step,
+    PrintPartial, HideValue, Font, Checkbox, Plain, Html, NoInteraction, Url, AutoScroll, Color,
+    ShowPalette, CustomPalette, Type, Pattern, Sample, Username, Prompt, AddEntry, AddMultilineEntry,
+    EntryValue, AddPassword, AddCalendar, AddList, ListValues, ColumnValues, AddCombo, ComboValues,
+    ComboDefault, ComboFreeEntry, ShowHeader, Tooltip, AddCheckbox, FormsFile, ListFile, NullInput,
+    SortColumn, NumericSort, OriginalOrder, Tree, Progressive, Foreground, Background, FontName,
+    TitleAlign, SlaveAlign, Lines, Unified, Persist, X, Y, W, Version, Calendar, Entry, Error, Info,
+    FileSelection, List, Notification, Progress, Question, Warning, Scale, TextInfo, ColorSelection,
+    FontSelection, Password, Forms, Dzen
+};
+
+struct Option
+{
+    const char *name;
+    const char *syntax; // appended to the name in the help
+    Opt id;             // Opt::Unhandled is help only, eg. because Qt or main() handles it
+    bool takesValue;
+    const char *note;   // untranslated prefix of the help
+    const char *help;
+};
+
+// the options of a table sorted by name, the compiler does that for every table that's looked up
+template <int N>
+struct OptionIndex
+{
+    const Option *options[N];
+};
+
+constexpr bool nameLess(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return static_cast<unsigned char>(*a) < static_cast<unsigned char>(*b);
+}
+
+template <int N>
+constexpr OptionIndex<N> sortedByName(const Option (&options)[N])
+{
+    OptionIndex<N> index{};
+    for (int i = 0; i < N; ++i) {
+        int j = i;
+        for (; j > 0 && nameLess(options[i].name, index.options[j-1]->name); --j)
+            index.options[j] = index.options[j-1];
+        index.options[j] = options + i;
+    }
+    return index;
+}
+
+template <const auto &Table>
+constexpr auto optionIndex = sortedByName(Table);
+
+template <const auto &Table>
+constexpr int optionCount = sizeof(Table) / sizeof(Option);
+
+struct OptionTable
+{
+    const char *category;
+    const char *title;
+    const Option *options;  // in help order
+    const Option *const *index; // by name
+    int count;
+};
+
+template <const auto &Table>
+constexpr OptionTable optionTable(const char *category, const char *title)
+{
+    return OptionTable { category, title, Table, optionIndex<Table>.options, optionCount<Table> };
+}
+
+#define QARMA_ONLY "QARMA ONLY! "
+
+static constexpr Option HelpOptions[] = {
+    { "-h, --help", "",             Opt::Unhandled, false, nullptr, HELP("Show help options") },
+    { "--help-all", "",             Opt::Unhandled, false, nullptr, HELP("Show all help options") },
+    { "--help-general", "",         Opt::Unhandled, false, nullptr, HELP("Show general options") },
+    { "--help-calendar", "",        Opt::Unhandled, false, nullptr, HELP("Show calendar options") },
+    { "--help-entry", "",           Opt::Unhandled, false, nullptr, HELP("Show text entry options") },
+    { "--help-error", "",           Opt::Unhandled, false, nullptr, HELP("Show error options") },
+    { "--help-info", "",            Opt::Unhandled, false, nullptr, HELP("Show info options") },
+    { "--help-file-selection", "",  Opt::Unhandled, false, nullptr, HELP("Show file selection options") },
+    { "--help-list", "",            Opt::Unhandled, false, nullptr, HELP("Show list options") },
+    { "--help-notification", "",    Opt::Unhandled, false, nullptr, HELP("Show notification icon options") },
+    { "--help-progress", "",        Opt::Unhandled, false, nullptr, HELP("Show progress options") },
+    { "--help-question", "",        Opt::Unhandled, false, nullptr, HELP("Show question options") },
+    { "--help-warning", "",         Opt::Unhandled, false, nullptr, HELP("Show warning options") },
+    { "--help-scale", "",           Opt::Unhandled, false, nullptr, HELP("Show scale options") },
+    { "--help-text-info", "",       Opt::Unhandled, false, nullptr, HELP("Show text information options") },
+    { "--help-color-selection", "", Opt::Unhandled, false, nullptr, HELP("Show color selection options") },
+    { "--help-font-selection", "",  Opt::Unhandled, false, nullptr, HELP("Show font selection options") },
+    { "--help-password", "",        Opt::Unhandled, false, nullptr, HELP("Show password dialog options") },
+    { "--help-forms", "",           Opt::Unhandled, false, nullptr, HELP("Show forms dialog options") },
+    { "--help-dzen", "",            Opt::Unhandled, false, nullptr, HELP("Show dzen options") },
+    { "--help-misc", "",            Opt::Unhandled, false, nullptr, HELP("Show miscellaneous options") },
+    { "--help-qt", "",              Opt::Unhandled, false, nullptr, HELP("Show Qt Options") },
+};
+
+static constexpr Option GeneralOptions[] = {
+    { "--title", "=TITLE",          Opt::Title, true, nullptr, HELP("Set the dialog title") },
+    { "--window-icon", "=ICONPATH", Opt::WindowIcon, true, nullptr, HELP("Set the window icon") },
+    { "--width", "=WIDTH",          Opt::Width, true, nullptr, HELP("Set the width (not entirely deterministic for message dialogs)") },
+    { "--height", "=HEIGHT",        Opt::Height, true, nullptr, HELP("Set the height (not entirely deterministic for message dialogs)") },
+    { "--pos", "=[+-]x[(+-)y]",     Opt::Pos, true, QARMA_ONLY, HELP("Set the position") },
+    { "--timeout", "=TIMEOUT",      Opt::Timeout, true, nullptr, HELP("Set dialog timeout in seconds") },
+    { "--ok-label", "=TEXT",        Opt::OkLabel, true, nullptr, HELP("Sets the label of the Ok button") },
+    { "--cancel-label", "=TEXT",    Opt::CancelLabel, true, nullptr, HELP("Sets the label of the Cancel button") },
+    { "--modal", "",                Opt::Modal, false, nullptr, HELP("Set the modal hint") },
+    { "--popup", "",                Opt::Popup, false, QARMA_ONLY, HELP("Open dialog as unframed and trasient popup window") },
+    { "--attach", "=WINDOW",        Opt::Attach, true, nullptr, HELP("Set the parent window to attach to") },
+};
+
+static constexpr Option CalendarOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--day", "=DAY",             Opt::Day, true, nullptr, HELP("Set the calendar day") },
+    { "--month", "=MONTH",         Opt::Month, true, nullptr, HELP("Set the calendar month") },
+    { "--year", "=YEAR",           Opt::Year, true, nullptr, HELP("Set the calendar year") },
+    { "--timeout", "=TIMEOUT",     Opt::Unhandled, true, nullptr, HELP("Set dialog timeout in seconds") },
+    { "--date-format", "=PATTERN", Opt::DateFormat, true, nullptr, HELP("Set the format for the returned date") },
+};
+
+static constexpr Option EntryOptions[] = {
+    { "--text", "=TEXT",            Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--entry-text", "=TEXT",      Opt::EntryText, true, nullptr, HELP("Set the entry text") },
+    { "--hide-text", "",            Opt::HideText, false, nullptr, HELP("Hide the entry text") },
+    { "--values", "=v1|v2|v3|...",  Opt::Values, true, QARMA_ONLY, HELP("Offer preset values to pick from") },
+    { "--int", "=integer",          Opt::Int, true, QARMA_ONLY, HELP("Integer input only, preset given value") },
+    { "--float", "=floating_point", Opt::Float, true, QARMA_ONLY, HELP("Floating point input only, preset given value") },
+};
+
+static constexpr Option ErrorOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--icon-name", "=ICON-NAME", Opt::IconName, true, nullptr, HELP("Set the dialog icon") },
+    { "--no-wrap", "",             Opt::NoWrap, false, nullptr, HELP("Do not enable text wrapping") },
+    { "--no-markup", "",           Opt::NoMarkup, false, nullptr, HELP("Do not enable html markup") },
+    { "--ellipsize", "",           Opt::Ellipsize, false, nullptr, HELP("Do wrap text, zenity has a rather special problem here") },
+    { "--selectable-labels", "",   Opt::SelectableLabels, false, QARMA_ONLY, HELP("Allow to select text for copy and paste") },
+};
+
+static constexpr Option InfoOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--icon-name", "=ICON-NAME", Opt::IconName, true, nullptr, HELP("Set the dialog icon") },
+    { "--no-wrap", "",             Opt::NoWrap, false, nullptr, HELP("Do not enable text wrapping") },
+    { "--no-markup", "",           Opt::NoMarkup, false, nullptr, HELP("Do not enable html markup") },
+    { "--ellipsize", "",           Opt::Ellipsize, false, nullptr, HELP("Do wrap text, zenity has a rather special problem here") },
+    { "--selectable-labels", "",   Opt::SelectableLabels, false, QARMA_ONLY, HELP("Allow to select text for copy and paste") },
+};
+
+static constexpr Option FileSelectionOptions[] = {
+    { "--filename", "=FILENAME",                        Opt::Filename, true, nullptr, HELP("Set the filename") },
+    { "--multiple", "",                                 Opt::Multiple, false, nullptr, HELP("Allow multiple files to be selected") },
+    { "--directory", "",                                Opt::Directory, false, nullptr, HELP("Activate directory-only selection") },
+    { "--save", "",                                     Opt::Save, false, nullptr, HELP("Activate save mode") },
+    { "--separator", "=SEPARATOR",                      Opt::Separator, true, nullptr, HELP("Set output separator character") },
+    { "--confirm-overwrite", "",                        Opt::ConfirmOverwrite, false, nullptr, HELP("Confirm file selection if filename already exists") },
+    { "--file-filter", "=NAME | PATTERN1 PATTERN2 ...", Opt::FileFilter, true, nullptr, HELP("Sets a filename filter") },
+    { "--preview-images", "=SIZE",                      Opt::PreviewImages, true, QARMA_ONLY, HELP("Show image thumbnails of SIZE") },
+};
+
+static constexpr Option ListOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--column", "=COLUMN",       Opt::Column, true, nullptr, HELP("Set the column header") },
+    { "--checklist", "",           Opt::Checklist, false, nullptr, HELP("Use check boxes for first column") },
+    { "--radiolist", "",           Opt::Radiolist, false, nullptr, HELP("Use radio buttons for first column") },
+    { "--imagelist", "",           Opt::Imagelist, false, nullptr, HELP("Use an image for first column") },
+    { "--separator", "=SEPARATOR", Opt::Separator, true, nullptr, HELP("Set output separator character") },
+    { "--multiple", "",            Opt::Multiple, false, nullptr, HELP("Allow multiple rows to be selected") },
+    { "--editable", "",            Opt::Editable, false, nullptr, HELP("Allow changes to text") },
+    { "--print-column", "=NUMBER", Opt::PrintColumn, true, nullptr, HELP("Print a specific column (Default is 1. 'ALL' can be used to print all columns)") },
+    { "--hide-column", "=NUMBER",  Opt::HideColumn, true, nullptr, HELP("Hide a specific column") },
+    { "--hide-header", "",         Opt::HideHeader, false, nullptr, HELP("Hides the column headers") },
+    { "--mid-search", "",          Opt::MidSearch, false, nullptr, HELP("Change list default search function searching for text in the middle, not on the beginning") },
+    { "--list-file", "=FILE",      Opt::ListFile, true, QARMA_ONLY, HELP("Read the rows from FILE (- for stdin), one per line with tab separated columns") },
+    { "--listen", "",              Opt::Listen, false, QARMA_ONLY, HELP("Read commands from stdin: add KEY CELLS..., update KEY COLUMN=VALUE..., remove KEY and clear") },
+    { "--null-input", "",          Opt::NullInput, false, QARMA_ONLY, HELP("The --list-file or stdin has NUL terminated cells, one after the other like the arguments") },
+    { "--sort-column", "=NUMBER",  Opt::SortColumn, true, QARMA_ONLY, HELP("Sort by a specific column, clicking a header sorts by that column (0 only allows the latter)") },
+    { "--numeric-sort", "",        Opt::NumericSort, false, QARMA_ONLY, HELP("Sort numbers by their value") },
+    { "--tree", "",                Opt::Tree, false, QARMA_ONLY, HELP("Every row starts with its key and the key of its parent (empty on top), children are loaded when their parent is expanded") },
+    { "--progressive", "",         Opt::Progressive, false, QARMA_ONLY, HELP("Show the dialog right away and add the rows while it's shown") },
+    { "--original-order", "",      Opt::OriginalOrder, false, QARMA_ONLY, HELP("Print the result in the original order instead of the sorted one") },
+};
+
+static constexpr Option NotificationOptions[] = {
+    { "--text", "=TEXT",         Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--listen", "",            Opt::Listen, false, nullptr, HELP("Listen for commands on stdin") },
+    { "--hint", "=TEXT",         Opt::Hint, true, nullptr, HELP("Set the notification hints") },
+    { "--selectable-labels", "", Opt::SelectableLabels, false, QARMA_ONLY, HELP("Allow to select text for copy and paste") },
+};
+
+static constexpr Option ProgressOptions[] = {
+    { "--text", "=TEXT",             Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--percentage", "=PERCENTAGE", Opt::Percentage, true, nullptr, HELP("Set initial percentage") },
+    { "--pulsate", "",               Opt::Pulsate, false, nullptr, HELP("Pulsate progress bar") },
+    { "--auto-close", "",            Opt::AutoClose, false, nullptr, HELP("Dismiss the dialog when 100% has been reached") },
+    { "--auto-kill", "",             Opt::AutoKill, false, nullptr, HELP("Kill parent process if Cancel button is pressed") },
+    { "--no-cancel", "",             Opt::NoCancel, false, nullptr, HELP("Hide Cancel button") },
+    { "--time-remaining", "",        Opt::TimeRemaining, false, nullptr, HELP("Estimate when progress will reach 100%") },
+};
+
+static constexpr Option QuestionOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--icon-name", "=ICON-NAME", Opt::IconName, true, nullptr, HELP("Set the dialog icon") },
+    { "--no-wrap", "",             Opt::NoWrap, false, nullptr, HELP("Do not enable text wrapping") },
+    { "--no-markup", "",           Opt::NoMarkup, false, nullptr, HELP("Do not enable html markup") },
+    { "--default-cancel", "",      Opt::DefaultCancel, false, nullptr, HELP("Give cancel button focus by default") },
+    { "--ellipsize", "",           Opt::Ellipsize, false, nullptr, HELP("Do wrap text, zenity has a rather special problem here") },
+    { "--selectable-labels", "",   Opt::SelectableLabels, false, QARMA_ONLY, HELP("Allow to select text for copy and paste") },
+};
+
+static constexpr Option WarningOptions[] = {
+    { "--text", "=TEXT",           Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--icon-name", "=ICON-NAME", Opt::IconName, true, nullptr, HELP("Set the dialog icon") },
+    { "--no-wrap", "",             Opt::NoWrap, false, nullptr, HELP("Do not enable text wrapping") },
+    { "--no-markup", "",           Opt::NoMarkup, false, nullptr, HELP("Do not enable html markup") },
+    { "--ellipsize", "",           Opt::Ellipsize, false, nullptr, HELP("Do wrap text, zenity has a rather special problem here") },
+    { "--selectable-labels", "",   Opt::SelectableLabels, false, QARMA_ONLY, HELP("Allow to select text for copy and paste") },
+};
+
+static constexpr Option ScaleOptions[] = {
+    { "--text", "=TEXT",       Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--value", "=VALUE",     Opt::Value, true, nullptr, HELP("Set initial value") },
+    { "--min-value", "=VALUE", Opt::MinValue, true, nullptr, HELP("Set minimum value") },
+    { "--max-value", "=VALUE", Opt::MaxValue, true, nullptr, HELP("Set maximum value") },
+    { "--step", "=VALUE",      Opt::Step, true, nullptr, HELP("Set step size") },
+    { "--print-partial", "",   Opt::PrintPartial, false, nullptr, HELP("Print partial values") },
+    { "--hide-value", "",      Opt::HideValue, false, nullptr, HELP("Hide value") },
+};
+
+static constexpr Option TextInfoOptions[] = {
+    { "--filename", "=FILENAME", Opt::Filename, true, nullptr, HELP("Open file") },
+    { "--editable", "",          Opt::Editable, false, nullptr, HELP("Allow changes to text") },
+    { "--font", "=TEXT",         Opt::Font, true, nullptr, HELP("Set the text font") },
+    { "--checkbox", "=TEXT",     Opt::Checkbox, true, nullptr, HELP("Enable an I read and agree checkbox") },
+    { "--plain", "",             Opt::Plain, false, QARMA_ONLY, HELP("Force plain text, zenity default limitation") },
+    { "--html", "",              Opt::Html, false, nullptr, HELP("Enable HTML support") },
+    { "--no-interaction", "",    Opt::NoInteraction, false, nullptr, HELP("Do not enable user interaction with the WebView. Only works if you use --html option") },
+    { "--url", "=URL",           Opt::Url, true, nullptr, HELP("Set an URL instead of a file. Shown while it loads, html is rendered again every now and then") },
+    { "--auto-scroll", "",       Opt::AutoScroll, false, nullptr, HELP("Auto scroll the text to the end. Only when text is captured from stdin") },
+};
+
+static constexpr Option ColorSelectionOptions[] = {
+    { "--color", "=VALUE",                     Opt::Color, true, nullptr, HELP("Set the color") },
+    { "--show-palette", "",                    Opt::ShowPalette, false, nullptr, HELP("Show the palette") },
+    { "--custom-palette", "=path/to/some.gpl", Opt::CustomPalette, true, QARMA_ONLY, HELP("Load a custom GPL for standard colors") },
+};
+
+static constexpr Option FontSelectionOptions[] = {
+    { "--type", "=[vector][,bitmap][,fixed][,variable]", Opt::Type, true, nullptr, HELP("Filter fonts (default: all)") },
+    { "--pattern", "=%1-%2:%3:%4",                       Opt::Pattern, true, nullptr, HELP("Output pattern, %1: Name, %2: Size, %3: weight, %4: slant") },
+    { "--sample", "=TEXT",                               Opt::Sample, true, nullptr, HELP("Sample text, defaults to the foxdogthing") },
+};
+
+static constexpr Option PasswordOptions[] = {
+    { "--username", "",    Opt::Username, false, nullptr, HELP("Display the username option") },
+    { "--prompt", "=TEXT", Opt::Prompt, true, QARMA_ONLY, HELP("The prompt for the user") },
+};
+
+static constexpr Option FormsOptions[] = {
+    { "--add-entry", "=Field name",                        Opt::AddEntry, true, nullptr, HELP("Add a new Entry in forms dialog") },
+    { "--add-multiline-entry", "=Field name",              Opt::AddMultilineEntry, true, nullptr, HELP("Add a new multiline Entry in forms dialog") },
+    { "--entry-value", "=TEXT",                            Opt::EntryValue, true, QARMA_ONLY, HELP("Preset text for the last entry") },
+    { "--add-password", "=Field name",                     Opt::AddPassword, true, nullptr, HELP("Add a new Password Entry in forms dialog") },
+    { "--add-calendar", "=Calendar field name",            Opt::AddCalendar, true, nullptr, HELP("Add a new Calendar in forms dialog") },
+    { "--add-list", "=List field and header name",         Opt::AddList, true, nullptr, HELP("Add a new List in forms dialog") },
+    { "--list-values", "=List of values separated by |",   Opt::ListValues, true, nullptr, HELP("List of values for List") },
+    { "--column-values", "=List of values separated by |", Opt::ColumnValues, true, nullptr, HELP("List of values for columns") },
+    { "--add-combo", "=Combo box field name",              Opt::AddCombo, true, nullptr, HELP("Add a new combo box in forms dialog") },
+    { "--combo-values", "=List of values separated by |",  Opt::ComboValues, true, nullptr, HELP("List of values for combo box") },
+    { "--combo-default", "=Value",                         Opt::ComboDefault, true, QARMA_ONLY, HELP("The default value of the last added combo box") },
+    { "--combo-free-entry", "",                            Opt::ComboFreeEntry, false, QARMA_ONLY, HELP("Allow to enter values not in the list the last added combo box") },
+    { "--show-header", "",                                 Opt::ShowHeader, false, nullptr, HELP("Show the columns header") },
+    { "--tooltip", "=ToolTip",                             Opt::Tooltip, true, QARMA_ONLY, HELP("Add a tooltip to the previous element") },
+    { "--text", "=TEXT",                                   Opt::Text, true, nullptr, HELP("Set the dialog text") },
+    { "--separator", "=SEPARATOR",                         Opt::Separator, true, nullptr, HELP("Set output separator character") },
+    { "--forms-date-format", "=PATTERN",                   Opt::DateFormat, true, nullptr, HELP("Set the format for the returned date") },
+    { "--add-checkbox", "=Checkbox label",                 Opt::AddCheckbox, true, QARMA_ONLY, HELP("Add a new Checkbox forms dialog") },
+    { "--progressive", "",                                 Opt::Progressive, false, QARMA_ONLY, HELP("Show the dialog right away and add the fields while it's shown") },
+    { "--forms-file", "=FILE",                             Opt::FormsFile, true, QARMA_ONLY, HELP("Read fields from FILE (- for stdin), one option per line: the name w/o dashes, a tab and the value. Lists and combos take tab separated values") },
+};
+
+static constexpr Option DzenOptions[] = {
+    { "-fg", " <color>",    Opt::Foreground, true, nullptr, HELP("Set foreground color. Either as symbolic name (e.g. red, darkgreen, etc.) or as #rrggbb hex-value.") },
+    { "-bg", " <color>",    Opt::Background, true, nullptr, HELP("Set background color (same format as -fg).") },
+    { "-fn", " <font>",     Opt::FontName, true, nullptr, HELP("Set font (using the format of xlsfonts and xfontsel).") },
+    { "-ta", " <l|c|r>",    Opt::TitleAlign, true, nullptr, HELP("Set alignement of title window content: l(eft), c(center) or r(ight).") },
+    { "-sa", " <l|c|r>",    Opt::SlaveAlign, true, nullptr, HELP("Set alignment of slave window (see -ta ).") },
+    { "-l", " <lines>",     Opt::Lines, true, nullptr, HELP("Number of lines to display in slave window.") },
+    { "-u", "",             Opt::Unified, false, nullptr, HELP("Update contents of title and slave window simultaneously.") },
+    { "-p", " [<timeout>]", Opt::Persist, false, nullptr, HELP("Persist EOF (optional timeout in seconds).") },
+    { "-x", " <pixels>",    Opt::X, true, nullptr, HELP("Set x position on the screen.") },
+    { "-y", " <pixels>",    Opt::Y, true, nullptr, HELP("Set y position on the screen.") },
+    { "-w", " <pixels>",    Opt::W, true, nullptr, HELP("width") },
+};
+
+static constexpr Option MiscOptions[] = {
+    { "--about", "",         Opt::Unhandled, false, nullptr, HELP("About Qarma") },
+    { "--version", "",       Opt::Version, false, nullptr, HELP("Print version") },
+    { "--trace", "=FILE",    Opt::Unhandled, true, QARMA_ONLY, HELP("Record the startup and streaming phases as Chrome trace into FILE") },
+    { "--stats", "[=FILE]",  Opt::Unhandled, false, QARMA_ONLY, HELP("Print input and repaint statistics to stderr or FILE on exit and SIGUSR1") },
+    { "--watchdog", "[=MS]", Opt::Unhandled, false, QARMA_ONLY, HELP("Log event loop stalls beyond MS (250) milliseconds, SIGUSR1 prints the last ones") },
+};
+
+static constexpr Option QtOptions[] = {
+    { "-platform", " <platformName[:options]>", Opt::Unhandled, true, nullptr, HELP("specifies the Qt Platform Abstraction (QPA) plugin") },
+    { "-platformpluginpath", " <path>",         Opt::Unhandled, true, nullptr, HELP("specifies the path to platform plugins") },
+    { "-platformtheme", " <platformTheme>",     Opt::Unhandled, true, nullptr, HELP("specifies the platform theme") },
+    { "-plugin", " <plugin>",                   Opt::Unhandled, true, nullptr, HELP("specifies additional plugins to load. Can appear multiple times") },
+    { "-qwindowgeometry", " <WxH+X+Y>",         Opt::Unhandled, true, nullptr, HELP("specifies window geometry for the main window") },
+    { "-qwindowicon", " <icon>",                Opt::Unhandled, true, nullptr, HELP("sets the default window icon") },
+    { "-qwindowtitle", " <title>",              Opt::Unhandled, true, nullptr, HELP("sets the title of the first window") },
+    { "-reverse", "",                           Opt::Unhandled, false, nullptr, HELP("sets the application's layout direction to Qt::RightToLeft") },
+    { "-display", " <hostname:screen_number>",  Opt::Unhandled, true, nullptr, HELP("switches displays on X11") },
+    { "-geometry", " <WxH+X+Y>",                Opt::Unhandled, true, nullptr, HELP("same as -qwindowgeometry") },
+};
+
+static constexpr Option ApplicationOptions[] = {
+    { "--calendar", "",        Opt::Calendar, false, nullptr, HELP("Display calendar dialog") },
+    { "--entry", "",           Opt::Entry, false, nullptr, HELP("Display text entry dialog") },
+    { "--error", "",           Opt::Error, false, nullptr, HELP("Display error dialog") },
+    { "--info", "",            Opt::Info, false, nullptr, HELP("Display info dialog") },
+    { "--file-selection", "",  Opt::FileSelection, false, nullptr, HELP("Display file selection dialog") },
+    { "--list", "",            Opt::List, false, nullptr, HELP("Display list dialog") },
+    { "--notification", "",    Opt::Notification, false, nullptr, HELP("Display notification") },
+    { "--progress", "",        Opt::Progress, false, nullptr, HELP("Display progress indication dialog") },
+    { "--question", "",        Opt::Question, false, nullptr, HELP("Display question dialog") },
+    { "--warning", "",         Opt::Warning, false, nullptr, HELP("Display warning dialog") },
+    { "--scale", "",           Opt::Scale, false, nullptr, HELP("Display scale dialog") },
+    { "--text-info", "",       Opt::TextInfo, false, nullptr, HELP("Display text information dialog") },
+    { "--color-selection", "", Opt::ColorSelection, false, nullptr, HELP("Display color selection dialog") },
+    { "--font-selection", "",  Opt::FontSelection, false, QARMA_ONLY, HELP("Display font selection dialog") },
+    { "--password", "",        Opt::Password, false, nullptr, HELP("Display password dialog") },
+    { "--forms", "",           Opt::Forms, false, nullptr, HELP("Display forms dialog") },
+    { "--dzen", "",            Opt::Dzen, false, QARMA_ONLY, HELP("Somewhat dzen compatible label") },
+    { "--display", "=DISPLAY", Opt::Unhandled, true, nullptr, HELP("X display to use") },
+    { "--class", "=CLASS",     Opt::Class, true, nullptr, HELP("Program class as used by the window manager") },
+    { "--name", "=NAME",       Opt::Name, true, nullptr, HELP("Program name as used by the window manager") },
+};
+
+// sorted by category, that's the --help-all order
+static constexpr OptionTable HelpCategories[] = {
+    optionTable<ApplicationOptions>("application", HELP("Application Options")),
+    optionTable<CalendarOptions>("calendar", HELP("Calendar options")),
+    optionTable<ColorSelectionOptions>("color-selection", HELP("Color selection options")),
+    optionTable<DzenOptions>("dzen", HELP("Dzen options")),
+    optionTable<EntryOptions>("entry", HELP("Text entry options")),
+    optionTable<ErrorOptions>("error", HELP("Error options")),
+    optionTable<FileSelectionOptions>("file-selection", HELP("File selection options")),
+    optionTable<FontSelectionOptions>("font-selection", HELP("Font selection options")),
+    optionTable<FormsOptions>("forms", HELP("Forms dialog options")),
+    optionTable<GeneralOptions>("general", HELP("General options")),
+    optionTable<HelpOptions>("help", HELP("Help options")),
+    optionTable<InfoOptions>("info", HELP("Info options")),
+    optionTable<ListOptions>("list", HELP("List Command\n  %1 --list [Options] [Item1 ...]\nList Options")),
+    optionTable<MiscOptions>("misc", HELP("Miscellaneous options")),
+    optionTable<NotificationOptions>("notification", HELP("Notification icon options")),
+    optionTable<PasswordOptions>("password", HELP("Password dialog options")),
+    optionTable<ProgressOptions>("progress", HELP("Progress options")),
+    optionTable<QtOptions>("qt", HELP("Qt options")),
+    optionTable<QuestionOptions>("question", HELP("Question options")),
+    optionTable<ScaleOptions>("scale", HELP("Scale options")),
+    optionTable<TextInfoOptions>("text-info", HELP("Text information options")),
+    optionTable<WarningOptions>("warning", HELP("Warning options")),
+};
+
+#endif //QARMA_OPTIONS_H
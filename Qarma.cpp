@@ -17,33 +17,42 @@
  */
 
 #include "Qarma.h"
+#include "Dzen.h"
+#include "FetcherInterface.h"
+#include "FontPicker.h"
+#include "Helpers.h"
+#include "InputGuard.h"
+#include "Instrumentation.h"
+#include "ListSorter.h"
+#include "ListTree.h"
+#include "NotifierInterface.h"
+#include "Options.h"
+#include "TextLoader.h"
+#include "ValueModel.h"
 
 #include <QAction>
 #include <QBoxLayout>
+#include <QCache>
 #include <QCalendarWidget>
 #include <QCheckBox>
 #include <QColorDialog>
 #include <QComboBox>
-#include <QCryptographicHash>
 #include <QDate>
-#ifndef QARMA_NO_DBUS
-#include <QDBusConnection>
-#include <QDBusConnectionInterface>
-#include <QDBusInterface>
-#endif
 #include <QDialogButtonBox>
+#include <QElapsedTimer>
 #include <QEvent>
+#include <QFile>
 #include <QFileDialog>
-#include <QFontDialog>
 #include <QFormLayout>
+#include <QHash>
 #include <QIcon>
-#include <QImageReader>
 #include <QInputDialog>
 #include <QLabel>
 #include <QLocale>
 #include <QLineEdit>
 #include <QMessageBox>
-#include <QProcess>
+#include <QPluginLoader>
+#include <QProgressBar>
 #include <QProgressDialog>
 #include <QPropertyAnimation>
 #include <QProxyStyle>
@@ -54,23 +63,30 @@
 #include <QSlider>
 #include <QSocketNotifier>
 #include <QSplitter>
-#include <QStandardPaths>
 #include <QStringBuilder>
 #include <QStringList>
 #include <QTextBrowser>
 #include <QTimer>
 #include <QTimerEvent>
+#include <QToolButton>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
+#include <QTreeWidgetItemIterator>
+#include <QUrl>
+#include <QVector>
 
 #if QT_VERSION >= 0x050000
-// this is to hack access to the --title parameter in Qt5
 #include <QWindow>
 #endif
 
 #include <QtDebug>
 
+#include <algorithm>
+#include <cerrno>
 #include <cfloat>
+#include <cstring>
+#include <functional>
+#include <memory>
 
 #ifdef Q_OS_UNIX
 #include <signal.h>
@@ -81,90 +97,6 @@
 #define ZENITY_VERSION "4.2.1"
 
 
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
-    #define SKIP_EMPTY Qt::SkipEmptyParts
-#else
-    #define SKIP_EMPTY QString::SkipEmptyParts
-#endif
-
-class InputGuard : public QObject
-{
-public:
-    InputGuard() : QObject(), m_guardedWidget(NULL), m_checkTimer(0) {}
-    static void watch(QWidget *w) {
-#if QT_VERSION >= 0x050000
-        if (qApp->platformName() == "wayland")
-            return;
-#endif
-        if (!s_instance)
-            s_instance = new InputGuard;
-        w->installEventFilter(s_instance);
-    }
-protected:
-    bool eventFilter(QObject *o, QEvent *e) {
-        QWidget *w = static_cast<QWidget*>(o);
-        switch (e->type()) {
-            case QEvent::FocusIn:
-            case QEvent::WindowActivate:
-                if (hasActiveFocus(w))
-                    guard(w);
-                break;
-            case QEvent::FocusOut:
-            case QEvent::WindowDeactivate:
-                if (w == m_guardedWidget && !hasActiveFocus(w))
-                    unguard(w);
-                break;
-            default:
-                break;
-        }
-        return false;
-    }
-    void timerEvent(QTimerEvent *te) {
-        if (te->timerId() == m_checkTimer && m_guardedWidget)
-            check(m_guardedWidget);
-        else
-            QObject::timerEvent(te);
-    }
-private:
-    bool check(QWidget *w) {
-#if QT_VERSION >= 0x050000
-        // try to re-grab
-        if (!w->window()->windowHandle()->setKeyboardGrabEnabled(true))
-            w->releaseKeyboard();
-#endif
-        if (w == QWidget::keyboardGrabber()) {
-            w->setPalette(QPalette());
-            return true;
-        }
-        w->setPalette(QPalette(Qt::white, Qt::red, Qt::white, Qt::black, Qt::gray,
-                               Qt::white, Qt::white, Qt::red, Qt::red));
-        return false;
-    }
-    void guard(QWidget *w) {
-        w->grabKeyboard();
-        if (check(w))
-            m_guardedWidget = w;
-        if (!m_checkTimer)
-            m_checkTimer = startTimer(500);
-    }
-    bool hasActiveFocus(QWidget *w) {
-        return w == QApplication::focusWidget() && w->isActiveWindow();
-    }
-    void unguard(QWidget *w) {
-        Q_ASSERT(m_guardedWidget == w);
-        killTimer(m_checkTimer);
-        m_checkTimer = 0;
-        m_guardedWidget = NULL;
-        w->releaseKeyboard();
-    }
-private:
-    QWidget *m_guardedWidget;
-    int m_checkTimer;
-    static InputGuard *s_instance;
-};
-
-InputGuard *InputGuard::s_instance = NULL;
-
 #ifdef WS_X11
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <QGuiApplication>
@@ -174,10 +106,34 @@ InputGuard *InputGuard::s_instance = NULL;
 #include <X11/Xlib.h>
 #endif
 
-typedef QPair<QString, QString> Help;
-typedef QList<Help> HelpList;
-typedef QPair<QString, HelpList> CategoryHelp;
-typedef QMap<QString, CategoryHelp> HelpDict;
+static const Option *findOption(const Option *const *index, int count, const QString &arg)
+{
+    // the index is sorted by the compiler, see optionIndex
+    const Option *const *end = index + count;
+    const Option *const *it = std::lower_bound(index, end, arg, [](const Option *option, const QString &arg) {
+        return arg.compare(QLatin1String(option->name)) > 0;
+    });
+    return (it != end && arg == QLatin1String((*it)->name)) ? *it : nullptr;
+}
+
+template <const auto &Table>
+static inline const Option *findOption(const QString &arg)
+{
+    return findOption(optionIndex<Table>.options, optionCount<Table>, arg);
+}
+
+// looks up args.at(i), consumes its value (if it takes one) and returns the id to switch over
+template <const auto &Table>
+static Opt readOption(const QStringList &args, int &i, QString &value)
+{
+    value.clear();
+    const Option *option = findOption<Table>(args.at(i));
+    if (!option || option->id == Opt::Unhandled) // help only, leave it to whoever handles it
+        return Opt::Unhandled;
+    if (option->takesValue && i + 1 < args.count())
+        value = args.at(++i);
+    return option->id;
+}
 
 
 Qarma::Qarma(int &argc, char **argv) : QApplication(argc, argv)
@@ -186,35 +142,39 @@ Qarma::Qarma(int &argc, char **argv) : QApplication(argc, argv)
 , m_popup(false)
 , m_parentWindow(0)
 , m_timeout(0)
-, m_notificationId(0)
 , m_dialog(NULL)
 , m_type(Invalid)
 {
+    Trace::end("QApplication init");
     m_pos = QPoint(INT_MAX, INT_MAX); // invalid
     m_size = QSize(0,0); // so we can reasonably use isNull …
+    Trace::begin("canonicalize arguments");
     QStringList argList = QCoreApplication::arguments(); // arguments() is slow
     const QString binary = argList.at(0);
     m_zenity = binary.endsWith("zenity");
     // make canonical list
     QStringList args;
-    if (argList.at(0).endsWith("-askpass")) {
+    if (binary.endsWith("-askpass")) {
         argList.removeFirst();
-        args << "--title" << tr("Enter Password") << "--password" << "--prompt" << argList.join(' ');
-    } else {
-        for (int i = 1; i < argList.count(); ++i) {
-            if (argList.at(i).startsWith("--")) {
-                int split = argList.at(i).indexOf('=');
-                if (split > -1) {
-                    args << argList.at(i).left(split) << argList.at(i).mid(split+1);
-                } else {
-                    args << argList.at(i);
-                }
+        Trace::end("canonicalize arguments");
+        showAskpass(argList.join(' '));
+        setupDialog();
+        return;
+    }
+    for (int i = 1; i < argList.count(); ++i) {
+        if (argList.at(i).startsWith("--")) {
+            int split = argList.at(i).indexOf('=');
+            if (split > -1) {
+                args << argList.at(i).left(split) << argList.at(i).mid(split+1);
             } else {
                 args << argList.at(i);
             }
+        } else {
+            args << argList.at(i);
         }
     }
     argList.clear();
+    Trace::end("canonicalize arguments");
 
     if (!readGeneral(args))
         return;
@@ -231,95 +191,104 @@ Qarma::Qarma(int &argc, char **argv) : QApplication(argc, argv)
         qputenv("RESOURCE_NAME", m_name.toLocal8Bit());
 
     char error = 1;
-    foreach (const QString &arg, args) {
-        if (arg == "--calendar") {
-            m_type = Calendar;
-            error = showCalendar(args);
-        } else if (arg == "--entry") {
-            m_type = Entry;
-            error = showEntry(args);
-        } else if (arg == "--error") {
-            m_type = Error;
-            error = showMessage(args, 'e');
-        } else if (arg == "--info") {
-            m_type = Info;
-            error = showMessage(args, 'i');
-        } else if (arg == "--file-selection") {
-            m_type = FileSelection;
-            error = showFileSelection(args);
-        } else if (arg == "--list") {
-            m_type = List;
-            error = showList(args);
-        } else if (arg == "--notification") {
-            m_type = Notification;
-            error = showNotification(args);
-        } else if (arg == "--progress") {
-            m_type = Progress;
-            error = showProgress(args);
-        } else if (arg == "--question") {
-            m_type = Question;
-            error = showMessage(args, 'q');
-        } else if (arg == "--warning") {
-            m_type = Warning;
-            error = showMessage(args, 'w');
-        } else if (arg == "--scale") {
-            m_type = Scale;
-            error = showScale(args);
-        } else if (arg == "--text-info") {
-            m_type = TextInfo;
-            error = showText(args);
-        } else if (arg == "--color-selection") {
-            m_type = ColorSelection;
-            error = showColorSelection(args);
-        } else if (arg == "--font-selection") {
-            m_type = FontSelection;
-            error = showFontSelection(args);
-        } else if (arg == "--password") {
-            m_type = Password;
-            error = showPassword(args);
-        } else if (arg == "--forms") {
-            m_type = Forms;
-            error = showForms(args);
-        } else if (arg == "--dzen") {
-            m_type = Dzen;
-            error = showDzen(args);
-        } else if (arg == "--version") {
-            printf("%s\n", m_zenity ? ZENITY_VERSION : QARMA_VERSION);
-            exit(0);
+    Trace::begin("construct dialog");
+    QString value;
+    for (int i = 0; i < args.count(); ++i) {
+        switch (readOption<ApplicationOptions>(args, i, value)) {
+            case Opt::Calendar:
+                m_type = Calendar;
+                error = showCalendar(args);
+                break;
+            case Opt::Entry:
+                m_type = Entry;
+                error = showEntry(args);
+                break;
+            case Opt::Error:
+                m_type = Error;
+                error = showMessage(args, 'e');
+                break;
+            case Opt::Info:
+                m_type = Info;
+                error = showMessage(args, 'i');
+                break;
+            case Opt::FileSelection:
+                m_type = FileSelection;
+                error = showFileSelection(args);
+                break;
+            case Opt::List:
+                m_type = List;
+                error = showList(args);
+                break;
+            case Opt::Notification:
+                m_type = Notification;
+                error = showNotification(args);
+                break;
+            case Opt::Progress:
+                m_type = Progress;
+                error = showProgress(args);
+                break;
+            case Opt::Question:
+                m_type = Question;
+                error = showMessage(args, 'q');
+                break;
+            case Opt::Warning:
+                m_type = Warning;
+                error = showMessage(args, 'w');
+                break;
+            case Opt::Scale:
+                m_type = Scale;
+                error = showScale(args);
+                break;
+            case Opt::TextInfo:
+                m_type = TextInfo;
+                error = showText(args);
+                break;
+            case Opt::ColorSelection:
+                m_type = ColorSelection;
+                error = showColorSelection(args);
+                break;
+            case Opt::FontSelection:
+                m_type = FontSelection;
+                error = showFontSelection(args);
+                break;
+            case Opt::Password:
+                m_type = Password;
+                error = showPassword(args);
+                break;
+            case Opt::Forms:
+                m_type = Forms;
+                error = showForms(args);
+                break;
+            case Opt::Dzen:
+                m_type = Dzen;
+                error = showDzen(args);
+                break;
+            default: {
+                const Option *misc = findOption<MiscOptions>(args.at(i));
+                if (misc && misc->id == Opt::Version) {
+                    printf("%s\n", m_zenity ? ZENITY_VERSION : QARMA_VERSION);
+                    exit(0);
+                }
+                break;
+            }
         }
         if (error != 1) {
             break;
         }
     }
+    Trace::end("construct dialog");
 
     if (error) {
         QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
         return;
     }
 
+    setupDialog();
+}
+
+void Qarma::setupDialog()
+{
     if (m_dialog) {
-#if QT_VERSION >= 0x050000
-        /*  Stage #1 one of "Setting a window title should be easy but Qt5 is dumb"
-            Qt5 sucks away "--title foo" but not "--title=foo" and then stumbles
-            over itself when trying to set it
-            So #1 we seek to get ourselfs access to the window title to get some
-            control over it
-
-            since it's set on showing the first QWindow, we just create one here
-            and copy the title
-        */
-        /// @todo: remove once this is fixed in Qt5 - ie. "never"
-        const bool qt5title = m_caption.isNull(); // otherwise we read it in the general options
-        if (qt5title) {
-            QWindow *w = new QWindow;
-            w->setVisible(true);
-            m_caption = w->title();
-            delete w;
-            m_dialog->setWindowTitle("");
-        }
-        m_dialog->setWindowTitle(m_caption);
-        // so much for stage one, see below for more on Qt5 being dumb...
-#endif
         // close on ctrl+return in addition to ctrl+enter
         QAction *shortAccept = new QAction(m_dialog);
         m_dialog->addAction(shortAccept);
@@ -354,28 +323,6 @@ Qarma::Qarma(int &argc, char **argv) : QApplication(argc, argv)
         }
         m_dialog->setWindowModality(m_modal ? Qt::ApplicationModal : Qt::NonModal);
 
-        /*  Stage #2 one of "Setting a window title should be easy but Qt5 is dumb"
-            Errhemmm... Fuck! This! Shit!
-            Not only is Qt5 too dumb to set the window title by parameter, if one
-            does it, at least on X11 Qt5 doesn't set the property on the platform
-            window *before* mapping it, but *while* - causing an IPC race condition
-            with the WMs that will pick up the "old" title, but also miss the property
-            update because it can happen while they're configuring the window.
-            Awesome.
-            Because we can't retroactively preceed the mapping, we at least need to
-            make sure that the title gets updated after the window is mapped and
-            configured - what we can only guess witha timer... *grrrrr*
-            Since setting the same title is idempotent and skipped in ::setWindowTitle
-            (what would be great if the entire thing wasn't broken to begin with)
-            We need two steps to first clear and second reset the title - maximzing
-            the server roundtrips...
-            But hey, abstract and wayland and QML... FUCK! THIS! SHIT! *grrrrrrrr*
-        */
-        // We do this after the dialog creation, because the setup can take varying times
-        if (!(m_caption.isNull() || binary.endsWith(m_caption)))
-            QTimer::singleShot(10, this, [=]() {m_dialog->setWindowTitle(""); m_dialog->setWindowTitle(m_caption);});
-        // so much for setting the window title - despite Qt trying to do it by itself
-
         if (!m_icon.isNull()) {
             QIcon icon = QIcon::fromTheme(m_icon);
             if (icon.availableSizes().isEmpty())
@@ -419,36 +366,54 @@ bool Qarma::error(const QString message)
     return true;
 }
 
-#define IF_IS(_TYPE_) if (const _TYPE_ *t = qobject_cast<const _TYPE_*>(w))
-
-static QString value(const QWidget *w, const QString &pattern)
+// --progressive, the dialog shows up right away and gets filled in slices between the events
+// step() adds a batch and returns whether there's more, done() runs once there isn't
+class Populator : public QTimer
 {
-    if (!w)
-        return QString();
-
-    IF_IS(QLineEdit) {
-        return t->text();
-    } else IF_IS(QTreeWidget) {
-        QString s;
-        foreach (QTreeWidgetItem *item, t->selectedItems()) {
-            for (int i = 0; i < t->columnCount(); ++i)
-                s += item->text(i);
-        }
-        return s;
-    } else IF_IS(QComboBox) {
-        return t->currentText();
-    } else IF_IS(QCalendarWidget) {
-        if (pattern.isNull())
-            return QLocale::system().toString(t->selectedDate(), QLocale::ShortFormat);
-        return t->selectedDate().toString(pattern);
-    } else IF_IS(QCheckBox) {
-        return t->isChecked() ? "true" : "false";
-    }
-    return QString();
-}
+public:
+    Populator(QDialog *dlg, QPushButton *ok, const std::function<bool()> &step, const std::function<void()> &done)
+    : QTimer(dlg), m_ok(ok), m_step(step), m_done(done)
+    {
+        setObjectName("qarma_populate");
+        if (m_ok)
+            m_ok->setEnabled(false);
+        connect(this, &QTimer::timeout, this, [this]() {
+            TRACE_SPAN("populate");
+            QElapsedTimer slice;
+            slice.start();
+            bool more = true;
+            while (more && slice.elapsed() < 12)
+                more = m_step();
+            if (!more)
+                complete();
+        });
+        start(0);
+    }
+    // finished before everything was there, but the result needs all of it
+    void flush() {
+        if (!isActive())
+            return;
+        TRACE_SPAN("populate");
+        while (m_step()) {}
+        complete();
+    }
+private:
+    void complete() {
+        stop();
+        deleteLater();
+        m_done();
+        if (m_ok)
+            m_ok->setEnabled(true);
+    }
+    QPushButton *m_ok;
+    std::function<bool()> m_step;
+    std::function<void()> m_done;
+};
 
 void Qarma::dialogFinished(int status)
 {
+    if (QTimer *populate = sender()->findChild<QTimer*>("qarma_populate"))
+        static_cast<Populator*>(populate)->flush();
     if (m_type == FileSelection) {
         QFileDialog *dlg = static_cast<QFileDialog*>(sender());
         QVariantList l;
@@ -523,7 +488,7 @@ void Qarma::dialogFinished(int status)
             break;
         }
         case FontSelection: {
-            QFontDialog *dlg = static_cast<QFontDialog*>(sender());
+            FontPicker *dlg = static_cast<FontPicker*>(sender());
             QFont fnt = dlg->selectedFont();
             int size = fnt.pointSize();
             if (size < 0)
@@ -572,7 +537,6 @@ void Qarma::dialogFinished(int status)
                     else if (column > 0)
                         --column;
                 }
-                bool done(false);
                 auto text = [=](const QTreeWidgetItem *twi, int col, int offset) {
                     if (col > -1)
                         return (col < offset) ? QString() : twi->text(col);
@@ -582,17 +546,28 @@ void Qarma::dialogFinished(int status)
                     s += twi->text(tw->columnCount()-1);
                     return s;
                 };
-                foreach (const QTreeWidgetItem *twi, tw->selectedItems()) {
-                    done = true;
-                    result << text(twi, column, 0);
-                }
-                if (!done) { // checkable
-                    for (int i = 0; i < tw->topLevelItemCount(); ++i) {
-                        const QTreeWidgetItem *twi = tw->topLevelItem(i);
-                        if (twi->checkState(0) == Qt::Checked)
-                            result << text(twi, column, 1);
+                QList<QTreeWidgetItem*> items = tw->selectedItems();
+                const bool checked = items.isEmpty();
+                if (checked)
+                    items = m_checkedItems.values();
+                const ListSorter *sorter = tw->findChild<ListSorter*>();
+                if (sorter && sorter->isSorted() && !sender()->property("qarma_original_order").toBool()) {
+                    // the sorted order, one pass over the list is cheaper than looking up the position of every item
+                    QSet<QTreeWidgetItem*> chosen;
+                    for (QTreeWidgetItem *twi : items)
+                        chosen.insert(twi);
+                    items.clear();
+                    for (QTreeWidgetItemIterator it(tw); *it && items.count() < chosen.count(); ++it) {
+                        if (chosen.contains(*it))
+                            items << *it;
                     }
+                } else { // w/o sorting, that's also the order of the list
+                    std::sort(items.begin(), items.end(), [](const QTreeWidgetItem *a, const QTreeWidgetItem *b) {
+                        return a->data(0, Qt::UserRole).toInt() < b->data(0, Qt::UserRole).toInt();
+                    });
                 }
+                for (const QTreeWidgetItem *twi : items)
+                    result << text(twi, column, checked ? 1 : 0);
             }
             printf("%s\n", qPrintable(result.join(sender()->property("qarma_separator").toString())));
             break;
@@ -620,53 +595,102 @@ void Qarma::quitOnError()
     exit(1);
 }
 
-#define NEXT_ARG QString((++i < args.count()) ? args.at(i) : QString())
-#define WARN_UNKNOWN_ARG(_KNOWN_) if (args.at(i).startsWith("--") && args.at(i) != _KNOWN_) qDebug() << "unspecific argument" << args.at(i);
-#define SHOW_DIALOG m_dialog = dlg; connect(dlg, SIGNAL(finished(int)), SLOT(dialogFinished(int))); dlg->show();
-#define READ_INT(_V_, _TYPE_, _ERROR_) bool ok; const int _V_ = NEXT_ARG.to##_TYPE_(&ok, 0); if (!ok) return !error(_ERROR_)
+bool Qarma::notify(QObject *receiver, QEvent *event)
+{
+    if (!(Trace::enabled() || Stats::enabled()))
+        return QApplication::notify(receiver, event);
+    if (event->type() == QEvent::Timer) {
+        Stats::timerEvent(receiver);
+        return QApplication::notify(receiver, event);
+    }
+    // the initial paint happens on the expose of the platform window, later ones on update requests to the widget
+    if (event->type() == QEvent::Expose && m_dialog && receiver == m_dialog->windowHandle()) {
+        static bool exposed = false;
+        if (!exposed)
+            Trace::instant("first expose");
+        exposed = true;
+    } else if (!(event->type() == QEvent::UpdateRequest && receiver->isWidgetType())) {
+        return QApplication::notify(receiver, event);
+    }
+    TRACE_SPAN("repaint");
+    Stats::painted();
+    return QApplication::notify(receiver, event);
+}
+
+// the dialog type itself is the only option of another table that's expected there
+#define WARN_UNKNOWN_ARG if (args.at(i).startsWith("--") && !findOption<ApplicationOptions>(args.at(i))) qDebug() << "unspecific argument" << args.at(i);
+// the title must be there before mapping the window, WMs tend to miss later updates
+#define SHOW_DIALOG m_dialog = dlg; connect(dlg, SIGNAL(finished(int)), SLOT(dialogFinished(int)));\
+                    if (!m_caption.isNull()) dlg->setWindowTitle(m_caption);\
+                    dlg->show();
+#define READ_INT(_V_, _TYPE_, _ERROR_) bool ok; const int _V_ = value.to##_TYPE_(&ok, 0); if (!ok) return !error(_ERROR_)
 
 bool Qarma::readGeneral(QStringList &args) {
+    TRACE_SPAN("readGeneral");
     QStringList remains;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--title") {
-            m_caption = NEXT_ARG;
-        } else if (args.at(i) == "--window-icon") {
-            m_icon = NEXT_ARG;
-        } else if (args.at(i) == "--width") {
-            READ_INT(w, UInt, "--width must be followed by a positive number");
-            m_size.setWidth(w);
-        } else if (args.at(i) == "--height") {
-            READ_INT(h, UInt, "--height must be followed by a positive number");
-            m_size.setHeight(h);
-        } else if (args.at(i) == "--pos") {
-            QString pos = NEXT_ARG;
-            QRegularExpressionMatch m = QRegularExpression("([+-]*[0-9]+)([+-][0-9]+)?").match(pos);
-            if (m.lastCapturedIndex() > 0 && m.lastCapturedIndex() < 3) {
-                m_pos.setX(m.captured(1).toInt());
-                m_pos.setY(m.lastCapturedIndex() == 2 ? m.captured(2).toInt() : 0);
-            } else {
-                return !error("--pos must be followed by a position [+-]x[(+-)y]");
+        Opt id = readOption<GeneralOptions>(args, i, value);
+        if (id == Opt::Unhandled) // --class and --name are listed as application options
+            id = readOption<ApplicationOptions>(args, i, value);
+        switch (id) {
+            case Opt::Title:
+                m_caption = value;
+                break;
+            case Opt::WindowIcon:
+                m_icon = value;
+                break;
+            case Opt::Width: {
+                READ_INT(w, UInt, "--width must be followed by a positive number");
+                m_size.setWidth(w);
+                break;
             }
-        } else if (args.at(i) == "--timeout") {
-            READ_INT(t, UInt, "--timeout must be followed by a positive number");
-            QTimer::singleShot(t*1000, this, SLOT(quit()));
-        } else if (args.at(i) == "--ok-label") {
-            m_ok = NEXT_ARG;
-        } else if (args.at(i) == "--cancel-label") {
-            m_cancel = NEXT_ARG;
-        } else if (args.at(i) == "--modal") {
-            m_modal = true;
-        } else if (args.at(i) == "--popup") {
-            m_popup = true;
-        } else if (args.at(i) == "--attach") {
-            READ_INT(w, UInt, "--attach must be followed by a positive number");
-            m_parentWindow = w;
-        } else if (args.at(i) == "--class") {
-            m_class = NEXT_ARG;
-        } else if (args.at(i) == "--name") {
-            m_name = NEXT_ARG;
-        } else {
-            remains << args.at(i);
+            case Opt::Height: {
+                READ_INT(h, UInt, "--height must be followed by a positive number");
+                m_size.setHeight(h);
+                break;
+            }
+            case Opt::Pos: {
+                QRegularExpressionMatch m = QRegularExpression("([+-]*[0-9]+)([+-][0-9]+)?").match(value);
+                if (m.lastCapturedIndex() > 0 && m.lastCapturedIndex() < 3) {
+                    m_pos.setX(m.captured(1).toInt());
+                    m_pos.setY(m.lastCapturedIndex() == 2 ? m.captured(2).toInt() : 0);
+                } else {
+                    return !error("--pos must be followed by a position [+-]x[(+-)y]");
+                }
+                break;
+            }
+            case Opt::Timeout: {
+                READ_INT(t, UInt, "--timeout must be followed by a positive number");
+                QTimer::singleShot(t*1000, this, SLOT(quit()));
+                break;
+            }
+            case Opt::OkLabel:
+                m_ok = value;
+                break;
+            case Opt::CancelLabel:
+                m_cancel = value;
+                break;
+            case Opt::Modal:
+                m_modal = true;
+                break;
+            case Opt::Popup:
+                m_popup = true;
+                break;
+            case Opt::Attach: {
+                READ_INT(w, UInt, "--attach must be followed by a positive number");
+                m_parentWindow = w;
+                break;
+            }
+            case Opt::Class:
+                m_class = value;
+                break;
+            case Opt::Name:
+                m_name = value;
+                break;
+            default:
+                remains << args.at(i);
+                break;
         }
     }
     args = remains;
@@ -687,24 +711,33 @@ char Qarma::showCalendar(const QStringList &args)
     int d,m,y;
     date.getDate(&y, &m, &d);
     bool ok;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text") {
-            vl->addWidget(new QLabel(NEXT_ARG, dlg));
-        } else if (args.at(i) == "--day") {
-            d = NEXT_ARG.toUInt(&ok);
-            if (!ok)
-                return !error("--day must be followed by a positive number");
-        } else if (args.at(i) == "--month") {
-            m = NEXT_ARG.toUInt(&ok);
-            if (!ok)
-                return !error("--month must be followed by a positive number");
-        } else if (args.at(i) == "--year") {
-            y = NEXT_ARG.toUInt(&ok);
-            if (!ok)
-                return !error("--year must be followed by a positive number");
-        } else if (args.at(i) == "--date-format") {
-            dlg->setProperty("qarma_date_format", NEXT_ARG);
-        } else { WARN_UNKNOWN_ARG("--calendar") }
+        switch (readOption<CalendarOptions>(args, i, value)) {
+            case Opt::Text:
+                vl->addWidget(new QLabel(value, dlg));
+                break;
+            case Opt::Day:
+                d = value.toUInt(&ok);
+                if (!ok)
+                    return !error("--day must be followed by a positive number");
+                break;
+            case Opt::Month:
+                m = value.toUInt(&ok);
+                if (!ok)
+                    return !error("--month must be followed by a positive number");
+                break;
+            case Opt::Year:
+                y = value.toUInt(&ok);
+                if (!ok)
+                    return !error("--year must be followed by a positive number");
+                break;
+            case Opt::DateFormat:
+                dlg->setProperty("qarma_date_format", value);
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
     date.setDate(y, m, d);
 
@@ -722,26 +755,41 @@ char Qarma::showCalendar(const QStringList &args)
 char Qarma::showEntry(const QStringList &args)
 {
     QInputDialog *dlg = new QInputDialog;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text")
-            dlg->setLabelText(labelText(NEXT_ARG));
-        else if (args.at(i) == "--entry-text")
-            dlg->setTextValue(NEXT_ARG);
-        else if (args.at(i) == "--hide-text")
-            dlg->setTextEchoMode(QLineEdit::Password);
-        else if (args.at(i) == "--values") {
-            dlg->setComboBoxItems(NEXT_ARG.split('|'));
-            dlg->setComboBoxEditable(true);
-        } else if (args.at(i) == "--int") {
-            dlg->setInputMode(QInputDialog::IntInput);
-            dlg->setIntRange(INT_MIN, INT_MAX);
-            dlg->setIntValue(NEXT_ARG.toInt());
-        } else if (args.at(i) == "--float") {
-            dlg->setInputMode(QInputDialog::DoubleInput);
-            dlg->setDoubleRange(DBL_MIN, DBL_MAX);
-            dlg->setDoubleValue(NEXT_ARG.toDouble());
-        }
-        else { WARN_UNKNOWN_ARG("--entry") }
+        switch (readOption<EntryOptions>(args, i, value)) {
+            case Opt::Text:
+                dlg->setLabelText(labelText(value));
+                break;
+            case Opt::EntryText:
+                dlg->setTextValue(value);
+                break;
+            case Opt::HideText:
+                dlg->setTextEchoMode(QLineEdit::Password);
+                break;
+            case Opt::Values: {
+                // QInputDialog only has the combo after it got items, but can't take a model
+                dlg->setComboBoxItems(QStringList());
+                if (QComboBox *combo = dlg->findChild<QComboBox*>()) {
+                    combo->clear();
+                    setComboValues(combo, value.split('|'));
+                }
+                dlg->setComboBoxEditable(true); // also picks the combo as input, now that it has items
+                break;
+            }
+            case Opt::Int:
+                dlg->setInputMode(QInputDialog::IntInput);
+                dlg->setIntRange(INT_MIN, INT_MAX);
+                dlg->setIntValue(value.toInt());
+                break;
+            case Opt::Float:
+                dlg->setInputMode(QInputDialog::DoubleInput);
+                dlg->setDoubleRange(DBL_MIN, DBL_MAX);
+                dlg->setDoubleValue(value.toDouble());
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
     SHOW_DIALOG
 
@@ -754,15 +802,22 @@ char Qarma::showPassword(const QStringList &args)
 
     QLineEdit *username(NULL), *password(NULL);
     QString prompt = tr("Enter password");
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--username") {
-            vl->addWidget(new QLabel(tr("Enter username"), dlg));
-            vl->addWidget(username = new QLineEdit(dlg));
-            username->setObjectName("qarma_username");
-            break;
-        } else if (args.at(i) == "--prompt") {
-            prompt = NEXT_ARG;
-        } { WARN_UNKNOWN_ARG("--password") }
+        switch (readOption<PasswordOptions>(args, i, value)) {
+            case Opt::Username:
+                if (!username) {
+                    vl->addWidget(new QLabel(tr("Enter username"), dlg));
+                    vl->addWidget(username = new QLineEdit(dlg));
+                    username->setObjectName("qarma_username");
+                }
+                break;
+            case Opt::Prompt:
+                prompt = value;
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
 
     vl->addWidget(new QLabel(prompt, dlg));
@@ -782,187 +837,197 @@ char Qarma::showPassword(const QStringList &args)
     return 0;
 }
 
-char Qarma::showMessage(const QStringList &args, char type)
+void Qarma::showAskpass(const QString &prompt)
 {
-    QMessageBox *dlg = new QMessageBox;
-    dlg->setStandardButtons((type == 'q') ? QMessageBox::Yes|QMessageBox::No : QMessageBox::Ok);
-    dlg->setDefaultButton(QMessageBox::Ok);
+    // ssh and sudo block on us, so this skips everything the generic path does for
+    // the general options and the title workarounds: no args, no settings, no roundtrips
+    // The constructor still runs setupDialog() for the shortcuts every dialog has
+    TRACE_SPAN("askpass");
+    m_type = Password;
+    QDialog *dlg = new QDialog;
+    dlg->setWindowTitle(tr("Enter Password"));
+    QVBoxLayout *vl = new QVBoxLayout(dlg);
+    vl->addWidget(new QLabel(prompt.isEmpty() ? tr("Enter password") : prompt, dlg));
+    QLineEdit *password = new QLineEdit(dlg);
+    vl->addWidget(password);
+    password->setEchoMode(QLineEdit::Password);
+    password->setFocus(Qt::OtherFocusReason);
+    InputGuard::watch(password); // that's the point of a password prompt
+    FINISH_DIALOG(QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
 
-    bool wrap = true, html = true;
-    for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text")
-            dlg->setText(html ? labelText(NEXT_ARG) : NEXT_ARG);
-        else if (args.at(i) == "--icon-name") {
-            const QString iconName = NEXT_ARG;
-            QPixmap pixmap = QIcon(iconName).pixmap(64);
-            if (pixmap.isNull())
-                pixmap = QIcon::fromTheme(iconName).pixmap(64);
-            dlg->setIconPixmap(pixmap);
-        }
-        else if (args.at(i) == "--no-wrap")
-            wrap = false;
-        else if (args.at(i) == "--ellipsize")
-            wrap = true;
-        else if (args.at(i) == "--no-markup")
-            html = false;
-        else if (args.at(i) == "--default-cancel")
-            dlg->setDefaultButton(QMessageBox::Cancel);
-        else if (args.at(i) == "--selectable-labels")
-            m_selectableLabel = true;
-        else if (args.at(i).startsWith("--") && args.at(i) != "--info" && args.at(i) != "--question" &&
-                                                args.at(i) != "--warning" && args.at(i) != "--error")
-            qDebug() << "unspecific argument" << args.at(i);
+    connect(dlg, &QDialog::finished, this, [=](int status) {
+        if (status != QDialog::Accepted) {
+            exit(1);
+            return;
+        }
+        const QByteArray pw = password->text().toLocal8Bit() + '\n';
+        qint64 written = 0;
+#ifdef Q_OS_UNIX
+        // straight to the fd, there's no point in buffering
+        while (written < pw.size()) {
+            const ssize_t n = ::write(STDOUT_FILENO, pw.constData() + written, pw.size() - written);
+            if (n < 0)
+                break;
+            written += n;
+        }
+#else
+        written = fwrite(pw.constData(), 1, pw.size(), stdout);
+#endif
+        exit(written == pw.size() ? 0 : 1);
+    });
+    m_dialog = dlg;
+    dlg->show();
+}
+
+// **** grrrrrrrr *****
+// https://github.com/luebking/qarma/issues/62
+// https://github.com/luebking/qarma/issues/70
+// https://runebook.dev/en/docs/qt/qmessagebox/resizeEvent
+// QMessageBox imposes its own size constraints in the show event and on every layout request,
+// so we let it and then impose ours - after the show event the window isn't mapped yet,
+// so it maps once at the final size instead of being corrected by a cascade of timers
+class MessageBox : public QMessageBox
+{
+public:
+    MessageBox() : QMessageBox(), m_sized(false), m_wrap(true), m_applying(false) {}
+    void setSizeRequest(const QSize &size, bool wrap) { m_request = size; m_wrap = wrap; m_sized = true; }
+protected:
+    bool event(QEvent *e) override {
+        const bool ret = QMessageBox::event(e);
+        if (m_dialogSize.isValid() && !m_applying &&
+            (e->type() == QEvent::Resize || e->type() == QEvent::LayoutRequest))
+            apply();
+        return ret;
     }
-    QLabel *msgLabel = dlg->findChild<QLabel*>("qt_msgbox_label");
-    if (msgLabel) {
-        // this is pointless because QMessageBox fucks around with that when applying its size constraints, see below
-//        msgLabel->setWordWrap(wrap);
-        msgLabel->setTextFormat(html ? Qt::RichText : Qt::PlainText);
-        if (m_selectableLabel)
-            msgLabel->setTextInteractionFlags(msgLabel->textInteractionFlags()|Qt::TextSelectableByMouse);
+    void showEvent(QShowEvent *e) override {
+        QMessageBox::showEvent(e);
+        if (m_sized && !m_dialogSize.isValid())
+            calculate();
+        apply();
     }
-    if (dlg->iconPixmap().isNull())
-        dlg->setIcon(type == 'w' ? QMessageBox::Warning :
-                   (type == 'q' ? QMessageBox::Question :
-                   (type == 'e' ? QMessageBox::Critical : QMessageBox::Information)));
-    SHOW_DIALOG
-    // **** grrrrrrrr *****
-    // https://github.com/luebking/qarma/issues/62
-    // https://github.com/luebking/qarma/issues/70
-    // https://runebook.dev/en/docs/qt/qmessagebox/resizeEvent
-    // the suggested spacer however doesn't work, but Qt allows us to fix the size after the show event
-    //
-    // still a lousy hack which might run into windowmanager related problems
-    if (!(wrap && m_size.isNull()) && msgLabel) {
-        if (m_size.width() > 0 && dlg->width() <= 500) {
+private:
+    void calculate() {
+        QLabel *msgLabel = findChild<QLabel*>("qt_msgbox_label");
+        if (!msgLabel)
+            return;
+        layout()->activate(); // so the geometries are what the show event just asked for
+        QSize request = m_request;
+        if (request.width() > 0 && width() <= 500) {
             // QMessageBox unconditionally disables wrapping for dialogs < 500px width, so don't try to shrink those
-            m_size.setWidth(qMax(m_size.width(), dlg->width()));
+            request.setWidth(qMax(request.width(), width()));
         }
         // figure the dimensions of the dialog if the label wasn't there
-        QLabel *icnLabel = dlg->findChild<QLabel*>("qt_msgboxex_icon_label");
+        QLabel *icnLabel = findChild<QLabel*>("qt_msgboxex_icon_label");
         QSize delta = msgLabel->size();
         // we need to account for the icon left of the label - if that's taller than the label
         // it dictates the labels effective height
         if (icnLabel)
             delta.setHeight(qMax(delta.height(), icnLabel->height()));
         // delta is now the virtual label size, subtract if from the dialog
-        delta = dlg->size() - delta;
-        QSize msgSize, dlgSize;
-        QMargins marge = msgLabel->contentsMargins() + QMargins(4,4,4,4);
-        if (!wrap) {
-            dlgSize = msgSize = msgLabel->fontMetrics().boundingRect(msgLabel->text()).size();
+        delta = size() - delta;
+        const QMargins marge = msgLabel->contentsMargins() + QMargins(4,4,4,4);
+        if (!m_wrap) {
+            m_labelSize = msgLabel->fontMetrics().boundingRect(msgLabel->text()).size();
         } else {
             // figure what size the label and by inference dialog should™ be
-            if (m_size.width() > 0)
-                msgLabel->setFixedWidth(m_size.width() - delta.width());
-            if (m_size.height() > 0)
-                msgLabel->setFixedHeight(m_size.height() - delta.height());
-            msgLabel->adjustSize();
-            dlgSize = msgSize = msgLabel->size();
-
-            // the fixed dimensions will break word wrapping, so release the size
-            msgLabel->setMinimumSize(0,0);
-            msgLabel->setMaximumSize(QWIDGETSIZE_MAX,QWIDGETSIZE_MAX);
+            const int w = request.width() > 0 ? request.width() - delta.width() : msgLabel->width();
+            int h = request.height() - delta.height();
+            if (request.height() <= 0)
+                h = msgLabel->hasHeightForWidth() ? msgLabel->heightForWidth(w) : msgLabel->height();
+            m_labelSize = QSize(w, h);
         }
-// fixing the dialog dimensions this way doesn't work because the 8x pad in marge is really important… for some reason…
-#if 0
-        if (m_size.width() > 0 && m_size.height() > 0) {
-            dlgSize = m_size;
-            delta = QSize(0,0);
-            marge = QMargins();
-        }
-#endif
-        m_size = QSize(0,0); // reset so the global size adjustment doesn't apply
-        // dlgSize is currently the label size, so reconstruct the context dimensions
-        dlgSize += QSize(marge.left()+marge.right(), marge.top()+marge.bottom());
+        // the label size plus its context is the dialog size
+        QSize dlgSize = m_labelSize + QSize(marge.left()+marge.right(), marge.top()+marge.bottom());
         // if there's an icon, our new label, regardless of the widths sufficient for one unwrapped line, gets at least its height
         if (icnLabel)
             dlgSize.setHeight(qMax(dlgSize.height(), icnLabel->height()));
-        dlgSize += delta;
-
-        // Since QMessageBox is adamant about screwing this up, track whether the label width stays what we asked for
-        // and otherwise fix its size. This *cannot* be unconditional because it would break word wrapping
-        auto forceSize = [=]() {
-            dlg->setFixedSize(dlgSize);
-            if (msgLabel->width() < msgSize.width() /*|| msgLabel->height() < msgSize.height()*/) {
-                msgLabel->setFixedSize(msgSize);
-                dlg->setFixedSize(dlgSize);
-            }
-        };
-        forceSize();
-        // here's the catch - the WM migth think the pre-showing size is mandatory
-        // (probably race condition between window mapping and the size fix and the WM handling client messages)
-        // so we briefly wait (100ms is a complete random time) and set the current size again to get the WM up to speed
-        for (int ms = 2; ms < 150; ms*=2) {
-            QTimer::singleShot(ms, this, [=]() { forceSize(); });
+        m_dialogSize = dlgSize + delta;
+    }
+    void apply() {
+        if (!m_dialogSize.isValid())
+            return;
+        // track whether the label width stays what we asked for and otherwise fix its size.
+        // This *cannot* be unconditional because it would break word wrapping
+        m_applying = true;
+        if (size() != m_dialogSize || minimumSize() != m_dialogSize || maximumSize() != m_dialogSize)
+            setFixedSize(m_dialogSize);
+        QLabel *msgLabel = findChild<QLabel*>("qt_msgbox_label");
+        if (msgLabel && msgLabel->width() < m_labelSize.width()) {
+            msgLabel->setFixedSize(m_labelSize);
+            setFixedSize(m_dialogSize);
         }
+        m_applying = false;
     }
-    return 0;
-}
+    QSize m_request, m_labelSize, m_dialogSize;
+    bool m_sized, m_wrap, m_applying;
+};
 
-QPixmap thumbnail(const QString &path, uint size)
+char Qarma::showMessage(const QStringList &args, char type)
 {
-    size = qMin(size, 1024u);
-    QImage thumb;
-    QImageReader thumbReader;
-    thumbReader.setFileName(path);
-    if (!thumbReader.canRead())
-        return QPixmap();
-
-    thumbReader.setQuality(50);
-    QSize sz = thumbReader.size();
-    QSize origSz = sz;
-    bool skipThumbnail = sz.width()*sz.height() < 1920*1200+1;
-
-    if (skipThumbnail) {
-        sz.scale(QSize(size,size), Qt::KeepAspectRatio);
-        thumbReader.setScaledSize(sz);
-    } else {
-        QFileInfo info(path);
-        QString canonicalPath = info.canonicalFilePath();
-        if (canonicalPath.isEmpty())
-            canonicalPath = info.absoluteFilePath();
-        QUrl url = QUrl::fromLocalFile(canonicalPath);
-        QCryptographicHash md5(QCryptographicHash::Md5);
-        md5.addData(QFile::encodeName(url.adjusted(QUrl::RemovePassword).url()));
-
-        QString folder;
-        uint tSize;
-        if (size <= 128) {
-            tSize = 128; folder = "normal/";
-        } else if (size <= 256) {
-            tSize = 256; folder = "large/";
-        } else if (size <= 512) {
-            tSize = 512; folder = "x-large/";
-        } else {
-            tSize = 1024; folder = "xx-large/";
-        }
-        Q_UNUSED(tSize);
-
-        const QString thumbPath = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) +
-                                                                    QLatin1String("/thumbnails/") + folder +
-                                                                    QString::fromLatin1(md5.result().toHex()) + QStringLiteral(".png");
-        QFileInfo tInfo(thumbPath);
-        if (tInfo.exists() && info.metadataChangeTime() <= tInfo.lastModified() && info.lastModified() <= tInfo.lastModified()) {
-            thumbReader.setFileName(thumbPath);
-            sz.scale(QSize(size,size), Qt::KeepAspectRatio);
-            thumbReader.setScaledSize(sz);
-            if (thumbReader.read(&thumb)) {
-                int w = thumb.text("Thumb::Image::Width").toInt();
-                int h = thumb.text("Thumb::Image::Height").toInt();
-                if (origSz == QSize(w, h))
-                    return QPixmap::fromImage(thumb);
+    MessageBox *dlg = new MessageBox;
+    dlg->setStandardButtons((type == 'q') ? QMessageBox::Yes|QMessageBox::No : QMessageBox::Ok);
+    dlg->setDefaultButton(QMessageBox::Ok);
+
+    bool wrap = true, html = true;
+    QString value;
+    // same ids, but eg. --default-cancel is only a question
+    auto readMessageOption = [&](int &i) {
+        switch (type) {
+            case 'e': return readOption<ErrorOptions>(args, i, value);
+            case 'q': return readOption<QuestionOptions>(args, i, value);
+            case 'w': return readOption<WarningOptions>(args, i, value);
+            default: return readOption<InfoOptions>(args, i, value);
+        }
+    };
+    for (int i = 0; i < args.count(); ++i) {
+        switch (readMessageOption(i)) {
+            case Opt::Text:
+                dlg->setText(html ? labelText(value) : value);
+                break;
+            case Opt::IconName: {
+                QPixmap pixmap = QIcon(value).pixmap(64);
+                if (pixmap.isNull())
+                    pixmap = QIcon::fromTheme(value).pixmap(64);
+                dlg->setIconPixmap(pixmap);
+                break;
             }
+            case Opt::NoWrap:
+                wrap = false;
+                break;
+            case Opt::Ellipsize:
+                wrap = true;
+                break;
+            case Opt::NoMarkup:
+                html = false;
+                break;
+            case Opt::DefaultCancel:
+                dlg->setDefaultButton(QMessageBox::Cancel);
+                break;
+            case Opt::SelectableLabels:
+                m_selectableLabel = true;
+                break;
+            default:
+                WARN_UNKNOWN_ARG
         }
-        thumbReader.setFileName(path);
-//        sz.scale(QSize(tSize,tSize), Qt::KeepAspectRatio); // in case we'll ever store the thumbnail
-        sz.scale(QSize(size,size), Qt::KeepAspectRatio);
-        thumbReader.setScaledSize(sz);
     }
-    if (!thumbReader.read(&thumb))
-        return QPixmap();
-//    if (skipThumbnail)
-        return QPixmap::fromImage(thumb);
+    QLabel *msgLabel = dlg->findChild<QLabel*>("qt_msgbox_label");
+    if (msgLabel) {
+        // this is pointless because QMessageBox fucks around with that when applying its size constraints, see MessageBox
+//        msgLabel->setWordWrap(wrap);
+        msgLabel->setTextFormat(html ? Qt::RichText : Qt::PlainText);
+        if (m_selectableLabel)
+            msgLabel->setTextInteractionFlags(msgLabel->textInteractionFlags()|Qt::TextSelectableByMouse);
+    }
+    if (dlg->iconPixmap().isNull())
+        dlg->setIcon(type == 'w' ? QMessageBox::Warning :
+                   (type == 'q' ? QMessageBox::Question :
+                   (type == 'e' ? QMessageBox::Critical : QMessageBox::Information)));
+    if (!(wrap && m_size.isNull()) && msgLabel) {
+        dlg->setSizeRequest(m_size, wrap);
+        m_size = QSize(0,0); // reset so the global size adjustment doesn't apply
+    }
+    SHOW_DIALOG
+    return 0;
 }
 
 class DblClckStyle : public QProxyStyle
@@ -992,46 +1057,56 @@ char Qarma::showFileSelection(const QStringList &args)
     if (!bookmarks.isEmpty())
         dlg->setSidebarUrls(bookmarks);
     QStringList mimeFilters;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--filename") {
-            QString path = NEXT_ARG;
-            if (path.endsWith("/."))
-                dlg->setDirectory(path);
-            else
-                dlg->selectFile(path);
-        }
-        else if (args.at(i) == "--multiple")
-            dlg->setFileMode(QFileDialog::ExistingFiles);
-        else if (args.at(i) == "--directory") {
-            dlg->setFileMode(QFileDialog::Directory);
-            dlg->setOption(QFileDialog::ShowDirsOnly);
-        } else if (args.at(i) == "--save") {
-            dlg->setFileMode(QFileDialog::AnyFile);
-            dlg->setAcceptMode(QFileDialog::AcceptSave);
-        }
-        else if (args.at(i) == "--separator")
-            dlg->setProperty("qarma_separator", NEXT_ARG);
-        else if (args.at(i) == "--confirm-overwrite")
-            dlg->setOption(QFileDialog::DontConfirmOverwrite);
-        else if (args.at(i) == "--file-filter") {
-            QString mimeFilter = NEXT_ARG;
-            const int idx = mimeFilter.indexOf('|');
-            if (idx > -1)
-                mimeFilter = mimeFilter.left(idx).trimmed() + " (" + mimeFilter.mid(idx+1).trimmed() + ")";
-            mimeFilters << mimeFilter;
-        } else if (args.at(i) == "--preview-images") {
-            READ_INT(size, UInt, "--preview-images must be followed by a positive number for the thumbnail size");
-            dlg->setOption(QFileDialog::DontUseNativeDialog);
-            if (QSplitter *splitter = dlg->findChild<QSplitter*>()) {
-                qApp->setStyle(new DblClckStyle);
-                QLabel *preview = new QLabel(splitter);
-                splitter->addWidget(preview);
-                connect(dlg, &QFileDialog::currentChanged, [=](const QString &path) {
-                    preview->setPixmap(thumbnail(path, size));
-                });
+        switch (readOption<FileSelectionOptions>(args, i, value)) {
+            case Opt::Filename:
+                if (value.endsWith("/."))
+                    dlg->setDirectory(value);
+                else
+                    dlg->selectFile(value);
+                break;
+            case Opt::Multiple:
+                dlg->setFileMode(QFileDialog::ExistingFiles);
+                break;
+            case Opt::Directory:
+                dlg->setFileMode(QFileDialog::Directory);
+                dlg->setOption(QFileDialog::ShowDirsOnly);
+                break;
+            case Opt::Save:
+                dlg->setFileMode(QFileDialog::AnyFile);
+                dlg->setAcceptMode(QFileDialog::AcceptSave);
+                break;
+            case Opt::Separator:
+                dlg->setProperty("qarma_separator", value);
+                break;
+            case Opt::ConfirmOverwrite:
+                dlg->setOption(QFileDialog::DontConfirmOverwrite);
+                break;
+            case Opt::FileFilter: {
+                QString mimeFilter = value;
+                const int idx = mimeFilter.indexOf('|');
+                if (idx > -1)
+                    mimeFilter = mimeFilter.left(idx).trimmed() + " (" + mimeFilter.mid(idx+1).trimmed() + ")";
+                mimeFilters << mimeFilter;
+                break;
+            }
+            case Opt::PreviewImages: {
+                READ_INT(size, UInt, "--preview-images must be followed by a positive number for the thumbnail size");
+                dlg->setOption(QFileDialog::DontUseNativeDialog);
+                if (QSplitter *splitter = dlg->findChild<QSplitter*>()) {
+                    qApp->setStyle(new DblClckStyle);
+                    QLabel *preview = new QLabel(splitter);
+                    splitter->addWidget(preview);
+                    connect(dlg, &QFileDialog::currentChanged, [=](const QString &path) {
+                        preview->setPixmap(thumbnail(path, size));
+                    });
+                }
+                break;
             }
+            default:
+                WARN_UNKNOWN_ARG
         }
-        else { WARN_UNKNOWN_ARG("--file-selection") }
     }
     dlg->setNameFilters(mimeFilters);
     SHOW_DIALOG
@@ -1043,46 +1118,46 @@ void Qarma::toggleItems(QTreeWidgetItem *item, int column)
     if (column)
         return; // not the checkmark
 
-    static bool recursion = false;
-    if (recursion)
+    if (item->checkState(0) != Qt::Checked) {
+        m_checkedItems.remove(item);
+        return;
+    }
+    if (m_checkedItems.contains(item))
+        return; // something else changed
+    if (!(item->treeWidget()->property("qarma_list_flags").toInt() & 1<<3)) {
+        m_checkedItems.insert(item);
         return;
-
-    recursion = true;
-    QTreeWidget *tw = item->treeWidget();
-    for (int i = 0; i < tw->topLevelItemCount(); ++i) {
-        QTreeWidgetItem *twi = tw->topLevelItem(i);
-        if (twi != item)
-            twi->setCheckState(0, Qt::Unchecked);
     }
-    recursion = false;
+    // radiolist, only the previous item needs to be unchecked - which calls back here and is a noop then
+    const QSet<QTreeWidgetItem*> previous = m_checkedItems;
+    m_checkedItems.clear();
+    m_checkedItems.insert(item);
+    for (QTreeWidgetItem *twi : previous)
+        twi->setCheckState(0, Qt::Unchecked);
+}
+
+// QTreeWidget::itemFromIndex() is protected
+static QTreeWidgetItem *itemAt(QTreeWidget *tw, const QModelIndex &parent, int row)
+{
+    if (!parent.isValid())
+        return tw->topLevelItem(row);
+    QTreeWidgetItem *item = itemAt(tw, parent.parent(), parent.row());
+    return item ? item->child(row) : nullptr;
 }
 
-static void addItems(QTreeWidget *tw, QStringList &values, bool editable, bool checkable, bool icons)
+// the rows first to last below parent along with all their children
+static QList<QTreeWidgetItem*> subtrees(QTreeWidget *tw, const QModelIndex &parent, int first, int last)
 {
-    for (int i = 0; i < values.count(); ) {
-        QStringList itemValues;
-        for (int j = 0; j < tw->columnCount(); ++j) {
-            itemValues << values.at(i++);
-            if (i == values.count())
-                break;
-        }
-        QTreeWidgetItem *item = new QTreeWidgetItem(tw, itemValues);
-        Qt::ItemFlags flags = item->flags();
-        if (editable)
-            flags |= Qt::ItemIsEditable;
-        if (checkable) {
-            flags |= Qt::ItemIsUserCheckable;
-            item->setCheckState(0, QVariant(item->text(0)).toBool() ? Qt::Checked : Qt::Unchecked);
-        }
-        if (icons)
-            item->setIcon(0, QPixmap(item->text(0)));
-        if (checkable || icons) {
-            item->setData(0, Qt::EditRole, item->text(0));
-            item->setText(0, QString());
-        }
-        item->setFlags(flags);
-        tw->addTopLevelItem(item);
+    QList<QTreeWidgetItem*> items;
+    for (int i = first; i <= last; ++i) {
+        if (QTreeWidgetItem *item = itemAt(tw, parent, i))
+            items << item;
     }
+    for (int i = 0; i < items.count(); ++i) {
+        for (int j = 0; j < items.at(i)->childCount(); ++j)
+            items << items.at(i)->child(j);
+    }
+    return items;
 }
 
 char Qarma::showList(const QStringList &args)
@@ -1099,65 +1174,133 @@ char Qarma::showList(const QStringList &args)
     tw->setRootIsDecorated(false);
     tw->setAllColumnsShowFocus(true);
 
-    bool editable(false), checkable(false), exclusive(false), icons(false), ok, needFilter(true);
+    bool editable(false), checkable(false), exclusive(false), icons(false), ok, needFilter(true), nullInput(false), listen(false), numericSort(false), tree(false),
+         progressive(false);
+    int sortColumn = -1;
+    QString listFile;
     QStringList columns;
     QStringList values;
     QList<int> hiddenCols;
     dlg->setProperty("qarma_separator", "|");
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text")
-            lbl->setText(labelText(NEXT_ARG));
-        else if (args.at(i) == "--multiple")
-            tw->setSelectionMode(QAbstractItemView::ExtendedSelection);
-        else if (args.at(i) == "--column") {
-            columns << NEXT_ARG;
-        } else if (args.at(i) == "--editable")
-            editable = true;
-        else if (args.at(i) == "--hide-header")
-            tw->setHeaderHidden(true);
-        else if (args.at(i) == "--separator")
-            dlg->setProperty("qarma_separator", NEXT_ARG);
-        else if (args.at(i) == "--hide-column") {
-            int v = NEXT_ARG.toInt(&ok);
-            if (ok)
-                hiddenCols << v-1;
-        } else if (args.at(i) == "--print-column") {
-            dlg->setProperty("qarma_print_column", NEXT_ARG);
-        } else if (args.at(i) == "--checklist") {
-            tw->setSelectionMode(QAbstractItemView::NoSelection);
-            tw->setAllColumnsShowFocus(false);
-            checkable = true;
-        } else if (args.at(i) == "--radiolist") {
-            tw->setSelectionMode(QAbstractItemView::NoSelection);
-            tw->setAllColumnsShowFocus(false);
-            checkable = true;
-            exclusive = true;
-        } else if (args.at(i) == "--imagelist") {
-            icons = true;
-        } else if (args.at(i) == "--mid-search") {
-            if (needFilter) {
-                needFilter = false;
-                QLineEdit *filter;
-                vl->addWidget(filter = new QLineEdit(dlg));
-                filter->setPlaceholderText(tr("Filter"));
-                connect (filter, &QLineEdit::textChanged, this, [=](const QString &match){
-                    for (int i = 0; i < tw->topLevelItemCount(); ++i)
-                        tw->topLevelItem(i)->setHidden(!tw->topLevelItem(i)->text(0).contains(match, Qt::CaseInsensitive));
-                });
+        switch (readOption<ListOptions>(args, i, value)) {
+            case Opt::Text:
+                lbl->setText(labelText(value));
+                break;
+            case Opt::Multiple:
+                tw->setSelectionMode(QAbstractItemView::ExtendedSelection);
+                break;
+            case Opt::Column:
+                columns << value;
+                break;
+            case Opt::Editable:
+                editable = true;
+                break;
+            case Opt::HideHeader:
+                tw->setHeaderHidden(true);
+                break;
+            case Opt::Separator:
+                dlg->setProperty("qarma_separator", value);
+                break;
+            case Opt::HideColumn: {
+                int v = value.toInt(&ok);
+                if (ok)
+                    hiddenCols << v-1;
+                break;
             }
-        } else if (args.at(i) != "--list") {
-            values << args.at(i);
+            case Opt::PrintColumn:
+                dlg->setProperty("qarma_print_column", value);
+                break;
+            case Opt::Checklist:
+                tw->setSelectionMode(QAbstractItemView::NoSelection);
+                tw->setAllColumnsShowFocus(false);
+                checkable = true;
+                break;
+            case Opt::Radiolist:
+                tw->setSelectionMode(QAbstractItemView::NoSelection);
+                tw->setAllColumnsShowFocus(false);
+                checkable = true;
+                exclusive = true;
+                break;
+            case Opt::Imagelist:
+                icons = true;
+                break;
+            case Opt::MidSearch:
+                if (needFilter) {
+                    needFilter = false;
+                    QLineEdit *filter;
+                    vl->addWidget(filter = new QLineEdit(dlg));
+                    filter->setPlaceholderText(tr("Filter"));
+                    connect (filter, &QLineEdit::textChanged, this, [=](const QString &match){
+                        for (int i = 0; i < tw->topLevelItemCount(); ++i)
+                            tw->topLevelItem(i)->setHidden(!tw->topLevelItem(i)->text(0).contains(match, Qt::CaseInsensitive));
+                    });
+                }
+                break;
+            case Opt::ListFile:
+                listFile = value;
+                break;
+            case Opt::NullInput:
+                nullInput = true;
+                break;
+            case Opt::Listen:
+                listen = true;
+                break;
+            case Opt::Tree:
+                tree = true;
+                break;
+            case Opt::Progressive:
+                progressive = true;
+                break;
+            case Opt::SortColumn:
+                sortColumn = qMax(0, value.toInt());
+                break;
+            case Opt::NumericSort:
+                numericSort = true;
+                break;
+            case Opt::OriginalOrder:
+                dlg->setProperty("qarma_original_order", true);
+                break;
+            default:
+                if (args.at(i) != "--list")
+                    values << args.at(i);
+                break;
         }
     }
-    if (values.isEmpty())
+    // stdin is streamed, files are mapped. qarma_list_input: 1 tsv, 2 nul, 3 commands
+    if (listen) {
+        tw->setProperty("qarma_list_input", 3);
+        listenToStdIn();
+    } else if (values.isEmpty() && (listFile.isEmpty() || listFile == "-")) {
+        if (nullInput || listFile == "-")
+            tw->setProperty("qarma_list_input", nullInput ? 2 : 1);
         listenToStdIn();
+    }
 
     if (checkable) {
         tw->setCurrentItem(nullptr);
         editable = false;
     }
 
-    tw->setProperty("qarma_list_flags", int(editable | checkable << 1 | icons << 2));
+    tw->setProperty("qarma_list_flags", int(editable | checkable << 1 | icons << 2 | exclusive << 3));
+    if (checkable) {
+        // keep track of the checked items, so neither the radiolist nor the result has to look at every row
+        connect(tw, SIGNAL(itemChanged(QTreeWidgetItem*, int)), SLOT(toggleItems(QTreeWidgetItem*, int)));
+        // items that were checked before they got into the list don't cause an itemChanged
+        // and with --tree rows come and go along with their children
+        connect(tw->model(), &QAbstractItemModel::rowsInserted, this, [=](const QModelIndex &parent, int first, int last) {
+            for (QTreeWidgetItem *item : subtrees(tw, parent, first, last)) {
+                if (item->checkState(0) == Qt::Checked)
+                    toggleItems(item, 0);
+            }
+        });
+        connect(tw->model(), &QAbstractItemModel::rowsAboutToBeRemoved, this, [=](const QModelIndex &parent, int first, int last) {
+            for (QTreeWidgetItem *item : subtrees(tw, parent, first, last))
+                m_checkedItems.remove(item);
+        });
+        connect(tw->model(), &QAbstractItemModel::modelAboutToBeReset, this, [=]() { m_checkedItems.clear(); });
+    }
 
     int columnCount = qMax(columns.count(), 1);
     tw->setColumnCount(columnCount);
@@ -1165,36 +1308,117 @@ char Qarma::showList(const QStringList &args)
     foreach (const int &i, hiddenCols)
         tw->setColumnHidden(i, true);
 
-    addItems(tw, values, editable, checkable, icons);
-
-    if (exclusive) {
-        connect (tw, SIGNAL(itemChanged(QTreeWidgetItem*, int)), SLOT(toggleItems(QTreeWidgetItem*, int)));
+    ListTree *listTree = nullptr;
+    if (tree) {
+        // ListSorter only sorts the top level and the children are created in key order
+        if (sortColumn > -1)
+            return !error("--tree cannot be combined with --sort-column");
+        if (!listFile.isEmpty() || nullInput || listen)
+            qWarning("--tree only reads rows from the arguments or line by line from stdin");
+        tw->setProperty("qarma_list_input", QVariant());
+        listFile.clear();
+        listTree = new ListTree(tw, editable, checkable, icons);
     }
-    for (int i = 0; i < columns.count(); ++i)
-        tw->resizeColumnToContents(i);
+    auto addRows = [=](QStringList rows) {
+        if (listTree)
+            listTree->addRows(rows);
+        else
+            addItems(tw, rows, editable, checkable, icons);
+    };
+    // the file rows come first either way, --progressive must not change the order
+    if (!listFile.isEmpty() && listFile != "-") {
+        QFile file;
+        const QByteArray data = mapInput(listFile, &file);
+        if (data.isNull())
+            return !error("--list-file " + listFile + " cannot be read");
+        addItems(tw, data.constData(), data.size(), nullInput, true, editable, checkable, icons);
+    }
+    if (!progressive)
+        addRows(values);
+    auto finish = [=]() {
+        if (sortColumn > -1) {
+            ListSorter *sorter = new ListSorter(tw, numericSort);
+            if (sortColumn > 0)
+                sorter->sort(sortColumn - 1, Qt::AscendingOrder);
+        }
+        for (int i = 0; i < columns.count(); ++i)
+            tw->resizeColumnToContents(i);
+    };
 
     FINISH_DIALOG(QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
+    if (progressive) {
+        const int batch = 256 * (columnCount + (tree ? 2 : 0));
+        int next = 0;
+        new Populator(dlg, btns->button(QDialogButtonBox::Ok), [=]() mutable {
+            addRows(values.mid(next, batch));
+            next += batch;
+            return next < values.count();
+        }, finish);
+    } else {
+        finish();
+    }
     SHOW_DIALOG
     return 0;
 }
 
+// NULL if the plugin isn't installed or there's no notification service
+static NotifierInterface *dbusNotifier()
+{
+    static bool loaded = false;
+    static NotifierInterface *notifier = NULL;
+    if (loaded)
+        return notifier;
+    loaded = true;
+    TRACE_SPAN("load notifier");
+    // next to the binary is for running from the build directory
+    const QStringList paths = QStringList() << QCoreApplication::applicationDirPath() + "/notify-dbus" << QARMA_PLUGIN_DIR;
+    foreach (const QString &path, paths) {
+        QPluginLoader loader(path + "/qarma-notify-dbus");
+        if (NotifierInterface *n = qobject_cast<NotifierInterface*>(loader.instance())) {
+            if (n->isAvailable()) {
+                notifier = n;
+                QObject::connect(n->object(), SIGNAL(sent()), qApp, SLOT(countDBusCall()));
+            }
+            break;
+        }
+    }
+    return notifier;
+}
+
+// NULL if the plugin isn't installed, --url is the only thing that needs QtNetwork
+static FetcherInterface *urlFetcher()
+{
+    static bool loaded = false;
+    static FetcherInterface *fetcher = NULL;
+    if (loaded)
+        return fetcher;
+    loaded = true;
+    TRACE_SPAN("load fetcher");
+    const QStringList paths = QStringList() << QCoreApplication::applicationDirPath() + "/url-fetch" << QARMA_PLUGIN_DIR;
+    foreach (const QString &path, paths) {
+        QPluginLoader loader(path + "/qarma-url-fetch");
+        if ((fetcher = qobject_cast<FetcherInterface*>(loader.instance())))
+            break;
+    }
+    return fetcher;
+}
+
+void Qarma::countDBusCall()
+{
+    Stats::dbusCall();
+}
+
 void Qarma::notify(const QString message, bool noClose)
 {
-#ifndef QARMA_NO_DBUS
-    if (QDBusConnection::sessionBus().interface()->isServiceRegistered("org.freedesktop.Notifications")) {
-        QDBusInterface notifications("org.freedesktop.Notifications", "/org/freedesktop/Notifications", "org.freedesktop.Notifications");
+    if (NotifierInterface *notifier = dbusNotifier()) {
         const QString summary = (message.length() < 32) ? message : message.left(25) + "...";
         QVariantMap hintMap;
         QStringList hintList = m_notificationHints.split(':');
         for (int i = 0; i < hintList.count() - 1; i+=2)
             hintMap.insert(hintList.at(i), hintList.at(i+1));
-        QDBusMessage msg = notifications.call("Notify", "Qarma", m_notificationId, "dialog-information", summary, message,
-                                              QStringList() /*actions*/, hintMap, m_timeout);
-        if (msg.arguments().count())
-            m_notificationId = msg.arguments().at(0).toUInt();
+        notifier->notify(summary, message, hintMap, m_timeout);
         return;
     }
-#endif
     QMessageBox *dlg = static_cast<QMessageBox*>(m_dialog);
     if (!dlg) {
         dlg = new QMessageBox;
@@ -1209,6 +1433,7 @@ void Qarma::notify(const QString message, bool noClose)
         }
     }
     dlg->setText(labelText(message));
+    Stats::update();
     SHOW_DIALOG
     dlg->adjustSize();
     dlg->move(QGuiApplication::screens().at(0)->availableGeometry().topRight() - QPoint(dlg->width() + 20, -20));
@@ -1218,22 +1443,36 @@ char Qarma::showNotification(const QStringList &args)
 {
     QString message;
     bool listening(false);
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text") {
-            message = NEXT_ARG;
-        } else if (args.at(i) == "--listen") {
-            listening = true;
-            listenToStdIn();
-        } else if (args.at(i) == "--hint") {
-            m_notificationHints = NEXT_ARG;
-        } else if (args.at(i) == "--selectable-labels") {
-            m_selectableLabel = true;
-        } else { WARN_UNKNOWN_ARG("--notification") }
+        switch (readOption<NotificationOptions>(args, i, value)) {
+            case Opt::Text:
+                message = value;
+                break;
+            case Opt::Listen:
+                listening = true;
+                listenToStdIn();
+                break;
+            case Opt::Hint:
+                m_notificationHints = value;
+                break;
+            case Opt::SelectableLabels:
+                m_selectableLabel = true;
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
     if (!message.isEmpty())
         notify(message, listening);
-    if (!(listening || m_dialog))
+    if (!(listening || m_dialog)) {
+        NotifierInterface *notifier = message.isEmpty() ? NULL : dbusNotifier();
+        if (notifier && notifier->busy()) { // don't quit before the message made it to the bus
+            connect(notifier->object(), SIGNAL(idle()), SLOT(quit()));
+            return 0;
+        }
         QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
     return 0;
 }
 
@@ -1258,13 +1497,61 @@ void Qarma::finishProgress()
 
 void Qarma::readStdIn()
 {
+    TRACE_SPAN("readStdIn");
     if (!gs_stdin->isOpen())
         return;
     QSocketNotifier *notifier = qobject_cast<QSocketNotifier*>(sender());
     if (notifier)
         notifier->setEnabled(false);
 
-    QByteArray ba = (m_type == TextInfo || m_type == List) ? gs_stdin->readAll() : gs_stdin->readLine();
+    QByteArray ba;
+#ifdef Q_OS_UNIX
+    if (m_type == Dzen && notifier) {
+        // the producer writes whenever it likes, readLine() would block until a line is complete.
+        // A single read() after the notifier fired never blocks and an incomplete line waits for its end
+        // No O_NONBLOCK on the fd: that would leak to whoever else shares it, eg. the shell on a tty
+        static QByteArray partial;
+        char chunk[16384];
+        const ssize_t n = ::read(gs_stdin->handle(), chunk, sizeof(chunk));
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                notifier->setEnabled(true);
+            return;
+        }
+        partial.append(chunk, n);
+        const int end = partial.lastIndexOf('\n');
+        if (n == 0) { // EOF, what's left is the last line - and the next read will find nothing
+            ba = partial;
+        } else if (end < 0) {
+            notifier->setEnabled(true);
+            return;
+        } else {
+            ba = partial.left(end + 1);
+        }
+        partial.remove(0, ba.size());
+    } else
+#endif
+    ba = (m_type == TextInfo || m_type == List) ? gs_stdin->readAll() : gs_stdin->readLine();
+    QTreeWidget *list = m_type == List ? m_dialog->findChild<QTreeWidget*>() : nullptr;
+    if (const int rawInput = list ? list->property("qarma_list_input").toInt() : 0) {
+        // --null-input, --list-file - or --listen, rows go straight into the list and may span reads
+        static QByteArray partial;
+        Stats::input(ba);
+        partial += ba;
+        const bool eof = ba.isEmpty() && notifier;
+        const int twflags = list->property("qarma_list_flags").toInt();
+        const qint64 consumed = rawInput == 3
+            ? listCommands(list, partial.constData(), partial.size(), eof, twflags & 1, twflags & 1<<1, twflags & 1<<2)
+            : addItems(list, partial.constData(), partial.size(), rawInput == 2, eof, twflags & 1, twflags & 1<<1, twflags & 1<<2);
+        partial.remove(0, consumed);
+        if (consumed)
+            Stats::update();
+        if (!eof) {
+            if (notifier)
+                notifier->setEnabled(true);
+            return;
+        }
+    }
     if (ba.isEmpty() && notifier) {
         gs_stdin->close();
 //         gs_stdin->deleteLater(); // hello segfault...
@@ -1274,6 +1561,7 @@ void Qarma::readStdIn()
             finishProgress();
         return;
     }
+    Stats::input(ba);
 
     static QString cachedText;
     QString newText = QString::fromLocal8Bit(ba);
@@ -1284,24 +1572,21 @@ void Qarma::readStdIn()
     }
 
     QStringList input;
-    if (m_type != TextInfo) {
-        if (newText.endsWith('\n'))
-            newText.resize(newText.length()-1);
-        input = newText.split('\n');
-    }
+    if (m_type != TextInfo)
+        input = inputLines(newText);
+    if (m_type != Notification) // notify() knows whether that shows up on screen
+        Stats::update(m_type == Progress ? input.count() : 1);
     if (m_type == Progress) {
         QProgressDialog *dlg = static_cast<QProgressDialog*>(m_dialog);
 
         const int oldValue = dlg->value();
-        bool ok;
         foreach (QString line, input) {
             if (line.startsWith('#')) {
                 dlg->setLabelText(labelText(line.mid(1)));
             } else {
-                static const QRegularExpression nondigit("[^0-9]");
-                int u = line.section(nondigit,0,0).toInt(&ok);
-                if (ok)
-                    dlg->setValue(qMin(100,u));
+                const int u = progressValue(line);
+                if (u > -1)
+                    dlg->setValue(u);
             }
         }
 
@@ -1328,10 +1613,7 @@ void Qarma::readStdIn()
             static QPropertyAnimation *animator = NULL;
             if (!animator || animator->state() != QPropertyAnimation::Running) {
                 const int oldValue = te->verticalScrollBar() ? te->verticalScrollBar()->value() : 0;
-                if (te->property("qarma_html").toBool())
-                    te->setHtml(te->toHtml() + cachedText);
-                else
-                    te->setPlainText(te->toPlainText() + cachedText);
+                appendText(te, cachedText);
                 cachedText.clear();
                 if (te->verticalScrollBar() && te->property("qarma_autoscroll").toBool()) {
                     te->verticalScrollBar()->setValue(oldValue);
@@ -1398,34 +1680,38 @@ void Qarma::readStdIn()
     } else if (m_type == List) {
         if (QTreeWidget *tw = m_dialog->findChild<QTreeWidget*>()) {
             const int twflags = tw->property("qarma_list_flags").toInt();
-            addItems(tw, input, twflags & 1, twflags & 1<<1, twflags & 1<<2);
+            if (ListTree *tree = tw->findChild<ListTree*>())
+                tree->addRows(input);
+            else
+                addItems(tw, input, twflags & 1, twflags & 1<<1, twflags & 1<<2);
         }
     } else if (m_type == Dzen) {
-        QLabel *header = m_dialog->findChild<QLabel*>("header");
-        QLabel *body = m_dialog->findChild<QLabel*>("body");
-        if (body) {
-            const int lines = body->property("lines").toInt();
-            const bool unified = m_dialog->property("unified").toBool();
-            for (int i = unified ? 0 : 1; i < lines; ++i)
-                input.append(QString::fromLocal8Bit(gs_stdin->readLine()));
-//            qDebug() << input;
-            if (header->text().isEmpty() || unified) {
-//                qDebug() << header->text().isEmpty() << m_dialog->property("unified").toBool() << "set header text";
-                header->setText(input.takeFirst());
-            }
-            if (!input.isEmpty()) {
-//                qDebug() << "have more input";
-                QStringList oldBody = body->text().split('\n');
-//                qDebug() << oldBody;
-                oldBody.append(input);
-//                qDebug() << "=>" << oldBody;
-                const int idx = qMax(0, oldBody.count() - lines);
-//                qDebug() << "==>" << oldBody.mid(idx);
-                body->setText(oldBody.mid(idx).join('\n'));
+        DzenView *header = m_dialog->findChild<DzenView*>("header");
+        DzenView *body = m_dialog->findChild<DzenView*>("body");
+        if (!body) {
+            header->setLine(0, input.constLast());
+        } else if (m_dialog->property("unified").toBool()) {
+            // blocks of a title line followed by the slave lines
+            static int row = 0;
+            for (const QString &line : input) {
+                if (row == 0)
+                    header->setLine(0, line);
+                else
+                    body->setLine(row - 1, line);
+                row = (row + 1) % (body->lineCount() + 1);
             }
         } else {
-//            qDebug() << "just set header";
-            header->setText(input.constLast());
+            // the first line is the title, everything else scrolls through the slave window
+            // an empty title is still the title, so that's tracked rather than guessed from the header
+            static bool haveTitle = false;
+            int i = 0;
+            if (!haveTitle) {
+                header->setLine(0, input.at(i++));
+                haveTitle = true;
+            }
+            // only the last lines fit anyway
+            for (i = qMax(i, input.count() - body->lineCount()); i < input.count(); ++i)
+                body->appendLine(input.at(i));
         }
     }
     if (notifier)
@@ -1451,24 +1737,34 @@ char Qarma::showProgress(const QStringList &args)
 {
     QProgressDialog *dlg = new QProgressDialog;
     dlg->setRange(0, 101);
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text")
-            dlg->setLabelText(labelText(NEXT_ARG));
-        else if (args.at(i) == "--percentage")
-            dlg->setValue(NEXT_ARG.toUInt());
-        else if (args.at(i) == "--pulsate")
-            dlg->setRange(0,0);
-        else if (args.at(i) == "--auto-close")
-            dlg->setProperty("qarma_autoclose", true);
-        else if (args.at(i) == "--auto-kill")
-            dlg->setProperty("qarma_autokill_parent", true);
-        else if (args.at(i) == "--no-cancel") {
-            if (QPushButton *btn = dlg->findChild<QPushButton*>())
-                btn->hide();
-        } else if (args.at(i) == "--time-remaining") {
-            dlg->setProperty("qarma_eta", true);
-        }
-        else { WARN_UNKNOWN_ARG("--progress") }
+        switch (readOption<ProgressOptions>(args, i, value)) {
+            case Opt::Text:
+                dlg->setLabelText(labelText(value));
+                break;
+            case Opt::Percentage:
+                dlg->setValue(value.toUInt());
+                break;
+            case Opt::Pulsate:
+                dlg->setRange(0,0);
+                break;
+            case Opt::AutoClose:
+                dlg->setProperty("qarma_autoclose", true);
+                break;
+            case Opt::AutoKill:
+                dlg->setProperty("qarma_autokill_parent", true);
+                break;
+            case Opt::NoCancel:
+                if (QPushButton *btn = dlg->findChild<QPushButton*>())
+                    btn->hide();
+                break;
+            case Opt::TimeRemaining:
+                dlg->setProperty("qarma_eta", true);
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
 
     listenToStdIn();
@@ -1508,28 +1804,42 @@ char Qarma::showScale(const QStringList &args)
     val->setNum(0);
 
     bool ok;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--text")
-            lbl->setText(labelText(NEXT_ARG));
-        else if (args.at(i) == "--value")
-            sld->setValue(NEXT_ARG.toInt());
-        else if (args.at(i) == "--min-value") {
-            int v = NEXT_ARG.toInt(&ok);
-            if (ok)
-                sld->setMinimum(v);
-        } else if (args.at(i) == "--max-value") {
-            int v = NEXT_ARG.toInt(&ok);
-            if (ok)
-                sld->setMaximum(v);
-        } else if (args.at(i) == "--step") {
-            int u = NEXT_ARG.toInt(&ok);
-            if (ok)
-                sld->setSingleStep(u);
-        } else if (args.at(i) == "--print-partial") {
-            connect (sld, SIGNAL(valueChanged(int)), SLOT(printInteger(int)));
-        } else if (args.at(i) == "--hide-value") {
-            val->hide();
-        } else { WARN_UNKNOWN_ARG("--scale") }
+        switch (readOption<ScaleOptions>(args, i, value)) {
+            case Opt::Text:
+                lbl->setText(labelText(value));
+                break;
+            case Opt::Value:
+                sld->setValue(value.toInt());
+                break;
+            case Opt::MinValue: {
+                int v = value.toInt(&ok);
+                if (ok)
+                    sld->setMinimum(v);
+                break;
+            }
+            case Opt::MaxValue: {
+                int v = value.toInt(&ok);
+                if (ok)
+                    sld->setMaximum(v);
+                break;
+            }
+            case Opt::Step: {
+                int u = value.toInt(&ok);
+                if (ok)
+                    sld->setSingleStep(u);
+                break;
+            }
+            case Opt::PrintPartial:
+                connect (sld, SIGNAL(valueChanged(int)), SLOT(printInteger(int)));
+                break;
+            case Opt::HideValue:
+                val->hide();
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
     SHOW_DIALOG
     return 0;
@@ -1547,29 +1857,41 @@ char Qarma::showText(const QStringList &args)
 
     QString filename;
     bool html(false), plain(false), onlyMarkup(false), url(false);
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--filename") {
-            filename = NEXT_ARG;
-        } else if (args.at(i) == "--url") {
-            filename = NEXT_ARG;
-            url = true;
-        }
-        else if (args.at(i) == "--editable")
-            te->setReadOnly(false);
-        else if (args.at(i) == "--font") {
-            te->setFont(QFont(NEXT_ARG));
-        } else if (args.at(i) == "--checkbox") {
-            vl->addWidget(cb = new QCheckBox(NEXT_ARG, dlg));
-        } else if (args.at(i) == "--auto-scroll") {
-            te->setProperty("qarma_autoscroll", true);
-        } else if (args.at(i) == "--html") {
-            html = true;
-            te->setProperty("qarma_html", true);
-        } else if (args.at(i) == "--plain") {
-            plain = true;
-        } else if (args.at(i) == "--no-interaction") {
-            onlyMarkup = true;
-        } else { WARN_UNKNOWN_ARG("--text-info") }
+        switch (readOption<TextInfoOptions>(args, i, value)) {
+            case Opt::Filename:
+                filename = value;
+                break;
+            case Opt::Url:
+                filename = value;
+                url = true;
+                break;
+            case Opt::Editable:
+                te->setReadOnly(false);
+                break;
+            case Opt::Font:
+                te->setFont(QFont(value));
+                break;
+            case Opt::Checkbox:
+                vl->addWidget(cb = new QCheckBox(value, dlg));
+                break;
+            case Opt::AutoScroll:
+                te->setProperty("qarma_autoscroll", true);
+                break;
+            case Opt::Html:
+                html = true;
+                te->setProperty("qarma_html", true);
+                break;
+            case Opt::Plain:
+                plain = true;
+                break;
+            case Opt::NoInteraction:
+                onlyMarkup = true;
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
 
     if (html) {
@@ -1591,12 +1913,43 @@ char Qarma::showText(const QStringList &args)
     if (filename.isNull()) {
         listenToStdIn();
     } else if (url) {
-        QProcess *curl = new QProcess;
-        connect(curl, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), [=]() {
-            te->setText(QString::fromLocal8Bit(curl->readAllStandardOutput()));
-            delete curl;
+        FetcherInterface *fetcher = urlFetcher();
+        if (!fetcher)
+            return !error("--url requires the qarma-url-fetch plugin");
+        // streamed into the document while it arrives
+        QIODevice *reply = fetcher->get(QUrl::fromUserInput(filename), dlg);
+        TextLoader *loader = new TextLoader(reply, te, html ? TextLoader::RichText : (plain ? TextLoader::PlainText : TextLoader::AutoDetect),
+                                            [=]() { return fetcher->contentType(reply); });
+
+        QHBoxLayout *hl = new QHBoxLayout;
+        vl->addLayout(hl);
+        QProgressBar *progress;
+        hl->addWidget(progress = new QProgressBar(dlg));
+        progress->setRange(0, 0); // busy until the size is known, if ever
+        QToolButton *stop;
+        hl->addWidget(stop = new QToolButton(dlg));
+        stop->setIcon(QIcon::fromTheme("process-stop"));
+        stop->setToolTip(tr("Stop loading"));
+        auto abort = [=]() {
+            loader->abort();
+            fetcher->abort(reply);
+        };
+        connect(stop, &QToolButton::clicked, reply, abort);
+        connect(dlg, &QDialog::finished, reply, abort);
+        fetcher->onProgress(reply, loader, [=](qint64 received, qint64 total) { loader->sourceProgress(received, total); });
+        connect(loader, &TextLoader::progress, progress, [=](int permille) {
+            if (permille > -1) {
+                progress->setRange(0, 1000);
+                progress->setValue(permille);
+            }
+        });
+        connect(loader, &TextLoader::finished, dlg, [=]() {
+            if (fetcher->failed(reply))
+                qWarning("%s: %s", qPrintable(filename), qPrintable(reply->errorString()));
+            progress->hide();
+            stop->hide();
+            reply->deleteLater();
         });
-        curl->start("curl", QStringList() << "-L" << "-s" << filename);
     } else {
         QFile file(filename);
         if (file.open(QIODevice::ReadOnly)) {
@@ -1628,16 +1981,21 @@ char Qarma::showColorSelection(const QStringList &args)
     QVariantList l = QSettings("qarma").value("CustomPalette").toList();
     for (int i = 0; i < l.count() && i < dlg->customCount(); ++i)
         dlg->setCustomColor(i, QColor(l.at(i).toUInt()));
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--color") {
-            dlg->setCurrentColor(QColor(NEXT_ARG));
-        } else if (args.at(i) == "--show-palette") {
-            qWarning("The show-palette parameter is not supported by qarma. Sorry.");
-            void(0);
-        } else if (args.at(i) == "--custom-palette") {
-            if (i+1 < args.count()) {
-                QString path = NEXT_ARG;
-                QFile file(path);
+        switch (readOption<ColorSelectionOptions>(args, i, value)) {
+            case Opt::Color:
+                dlg->setCurrentColor(QColor(value));
+                break;
+            case Opt::ShowPalette:
+                qWarning("The show-palette parameter is not supported by qarma. Sorry.");
+                break;
+            case Opt::CustomPalette: {
+                if (value.isNull()) {
+                    qWarning("You have to provide a gimp palette (*.gpl)");
+                    break;
+                }
+                QFile file(value);
                 if (file.open(QIODevice::ReadOnly)) {
                     QStringList pal = QString::fromLocal8Bit(file.readAll()).split('\n');
                     int r, g, b; bool ok; int idx = 0;
@@ -1655,12 +2013,13 @@ char Qarma::showColorSelection(const QStringList &args)
                     }
                     file.close();
                 } else {
-                    qWarning("Cannot read %s", path.toLocal8Bit().constData());
+                    qWarning("Cannot read %s", value.toLocal8Bit().constData());
                 }
-            } else {
-                qWarning("You have to provide a gimp palette (*.gpl)");
+                break;
             }
-        }{ WARN_UNKNOWN_ARG("--color-selection") }
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
     SHOW_DIALOG
     return 0;
@@ -1668,71 +2027,181 @@ char Qarma::showColorSelection(const QStringList &args)
 
 char Qarma::showFontSelection(const QStringList &args)
 {
-    QFontDialog *dlg = new QFontDialog;
+    TRACE_SPAN("font dialog");
+    int types = 0;
     QString pattern = "%1-%2:%3:%4";
     QString sample = "The quick brown fox jumps over the lazy dog";
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--type") {
-            QStringList types = NEXT_ARG.split(',');
-            QFontDialog::FontDialogOptions opts;
-            for (const QString &type : types) {
-                if (type == "vector")   opts |= QFontDialog::ScalableFonts;
-                if (type == "bitmap")   opts |= QFontDialog::NonScalableFonts;
-                if (type == "fixed")    opts |= QFontDialog::MonospacedFonts;
-                if (type == "variable") opts |= QFontDialog::ProportionalFonts;
+        switch (readOption<FontSelectionOptions>(args, i, value)) {
+            case Opt::Type: {
+                QStringList typeList = value.split(',');
+                for (const QString &type : typeList) {
+                    if (type == "vector")   types |= FontPicker::Vector;
+                    if (type == "bitmap")   types |= FontPicker::Bitmap;
+                    if (type == "fixed")    types |= FontPicker::Fixed;
+                    if (type == "variable") types |= FontPicker::Variable;
+                }
+                break;
             }
-            if (opts) // https://bugreports.qt.io/browse/QTBUG-93473
-                dlg->setOptions(opts);
-            dlg->setCurrentFont(QFont()); // also works around the bug :P
-        } else if (args.at(i) == "--pattern") {
-            pattern = NEXT_ARG;
-            if (!pattern.contains("%1"))
-                qWarning("The output pattern doesn't include a placeholder for the font name...");
-        } else if (args.at(i) == "--sample") {
-            sample = NEXT_ARG;
-        } { WARN_UNKNOWN_ARG("--font-selection") }
-    }
-    if (QLineEdit *smpl = dlg->findChild<QLineEdit*>("qt_fontDialog_sampleEdit"))
-        smpl->setText(sample);
+            case Opt::Pattern:
+                pattern = value;
+                if (!pattern.contains("%1"))
+                    qWarning("The output pattern doesn't include a placeholder for the font name...");
+                break;
+            case Opt::Sample:
+                sample = value;
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
+    }
+    FontPicker *dlg = new FontPicker(types);
+    dlg->setSampleText(sample);
     dlg->setProperty("qarma_fontpattern", pattern);
     SHOW_DIALOG
     return 0;
 }
 
-static void buildList(QTreeWidget **tree, QStringList &values, QStringList &columns, bool &showHeader)
+// one --forms option, the value lists are split up front
+struct FormField
 {
-    QTreeWidget *tw = *tree;
-
-    if (!tw)
-        return;
+    Opt id;
+    QString value;
+    QStringList values;
+};
 
-    int columnCount = columns.count();
-    tw->setHeaderHidden(!showHeader);
-    if (columns.count()) {
-        tw->setColumnCount(columns.count());
-        tw->setHeaderLabels(columns);
-    } else {
-        columnCount = 1;
+// the --forms widgets, added field by field from the arguments or a --forms-file
+class FormBuilder
+{
+public:
+    FormBuilder(QDialog *dlg, QVBoxLayout *vl) : m_dlg(dlg), m_list(nullptr), m_listHeader(false)
+                                               , m_combo(nullptr), m_combo4V(nullptr), m_entry(nullptr), m_widget(nullptr) {
+        vl->addWidget(m_label = new QLabel(dlg));
+        QFont fnt = m_label->font();
+        fnt.setBold(true);
+        m_label->setFont(fnt);
+        vl->addLayout(m_form = new QFormLayout);
     }
+    bool add(Opt id, const QString &value); // false if that's not a forms option
+    void setValues(Opt id, const QStringList &values);
+    void finish() { buildList(&m_list, m_listValues, m_listColumns, m_listHeader); }
+private:
+    QDialog *m_dlg;
+    QLabel *m_label;
+    QFormLayout *m_form;
+    QTreeWidget *m_list;
+    QStringList m_listValues, m_listColumns, m_comboValues;
+    bool m_listHeader;
+    QComboBox *m_combo, *m_combo4V;
+    QWidget *m_entry, *m_widget;
+    QString m_entryValue;
+};
 
-
-    for (int i = 0; i < values.count(); ) {
-        QStringList itemValues;
-        for (int j = 0; j < columnCount; ++j) {
-            itemValues << values.at(i++);
-            if (i == values.count())
-                break;
+bool FormBuilder::add(Opt id, const QString &value)
+{
+    switch (id) {
+        case Opt::AddEntry: {
+            QLineEdit *lastLineEdit;
+            m_form->addRow(value, m_widget = m_entry = lastLineEdit = new QLineEdit(m_dlg));
+            lastLineEdit->setText(m_entryValue);
+            lastLineEdit->setPlaceholderText(m_entryValue);
+            break;
         }
-        tw->addTopLevelItem(new QTreeWidgetItem(tw, itemValues));
+        case Opt::AddMultilineEntry: {
+            QTextEdit *lastTextEdit;
+            m_form->addRow(value, m_widget = m_entry = lastTextEdit = new QTextEdit(m_dlg));
+            lastTextEdit->setText(m_entryValue);
+            lastTextEdit->setPlaceholderText(m_entryValue);
+            break;
+        }
+        case Opt::EntryValue:
+            m_entryValue = value;
+            if (m_entry) {
+                if (QLineEdit *lastLineEdit = qobject_cast<QLineEdit*>(m_entry)) {
+                    lastLineEdit->setText(m_entryValue);
+                    lastLineEdit->setPlaceholderText(m_entryValue);
+                }
+                else if (QTextEdit *lastTextEdit = qobject_cast<QTextEdit*>(m_entry)) {
+                    lastTextEdit->setText(m_entryValue);
+                    lastTextEdit->setPlaceholderText(m_entryValue);
+                }
+                m_entryValue.clear();
+                m_entry = nullptr;
+            }
+            break;
+        case Opt::AddPassword: {
+            QLineEdit *le;
+            m_form->addRow(value, m_widget = le = new QLineEdit(m_dlg));
+            le->setEchoMode(QLineEdit::Password);
+            break;
+        }
+        case Opt::AddCalendar:
+            m_form->addRow(value, m_widget = new QCalendarWidget(m_dlg));
+            break;
+        case Opt::AddList:
+            buildList(&m_list, m_listValues, m_listColumns, m_listHeader);
+            m_form->addRow(value, m_widget = m_list = new QTreeWidget(m_dlg));
+            break;
+        case Opt::ListValues:
+        case Opt::ColumnValues:
+        case Opt::ComboValues:
+            setValues(id, value.split('|'));
+            break;
+        case Opt::AddCombo:
+            m_form->addRow(value, m_widget = m_combo4V = m_combo = new QComboBox(m_dlg));
+            setComboValues(m_combo, m_comboValues);
+            m_comboValues.clear();
+            break;
+        case Opt::ComboDefault:
+            if (m_combo)
+                m_combo->setCurrentText(value);
+            break;
+        case Opt::ComboFreeEntry:
+            if (m_combo)
+                m_combo->setEditable(true);
+            break;
+        case Opt::ShowHeader:
+            m_listHeader = true;
+            break;
+        case Opt::Text:
+            m_label->setText(value);
+            break;
+        case Opt::Separator:
+            m_dlg->setProperty("qarma_separator", value);
+            break;
+        case Opt::DateFormat:
+            m_dlg->setProperty("qarma_date_format", value);
+            break;
+        case Opt::AddCheckbox:
+            m_form->addRow(m_widget = new QCheckBox(value, m_dlg));
+            break;
+        case Opt::Tooltip:
+            if (m_widget) {
+                m_widget->setToolTip(value);
+                m_widget = nullptr;
+            }
+            break;
+        default:
+            return false;
     }
+    return true;
+}
 
-    for (int i = 0; i < columns.count(); ++i)
-        tw->resizeColumnToContents(i);
-
-    values.clear();
-    columns.clear();
-    showHeader = false;
-    *tree = NULL;
+void FormBuilder::setValues(Opt id, const QStringList &values)
+{
+    if (id == Opt::ListValues) {
+        m_listValues = values;
+    } else if (id == Opt::ColumnValues) {
+        m_listColumns = values;
+    } else if (id == Opt::ComboValues) {
+        if (m_combo4V) {
+            setComboValues(m_combo4V, values);
+            m_combo4V = nullptr;
+        } else {
+            m_comboValues = values;
+        }
+    }
 }
 
 char Qarma::showForms(const QStringList &args)
@@ -1740,143 +2209,97 @@ char Qarma::showForms(const QStringList &args)
     NEW_DIALOG
     dlg->setProperty("qarma_separator", "|");
 
-    QLabel *label;
-    vl->addWidget(label = new QLabel(dlg));
-    QFont fnt = label->font();
-    fnt.setBold(true);
-    label->setFont(fnt);
-
-    QFormLayout *fl;
-    vl->addLayout(fl = new QFormLayout);
-
-    QTreeWidget *lastList = NULL;
-    QStringList lastListValues, lastListColumns, lastComboValues;
-    bool lastListHeader(false);
-    QComboBox *lastCombo = nullptr, *lastCombo4V = nullptr;
-    QWidget *lastEntry = nullptr, *lastWidget = nullptr;
-    QString lastEntryValue;
+    std::shared_ptr<FormBuilder> form = std::make_shared<FormBuilder>(dlg, vl);
+    QList<FormField> fields;
+    bool progressive = false;
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "--add-entry") {
-            QLineEdit *lastLineEdit;
-            fl->addRow(NEXT_ARG, lastWidget = lastEntry = lastLineEdit = new QLineEdit(dlg));
-            lastLineEdit->setText(lastEntryValue);
-            lastLineEdit->setPlaceholderText(lastEntryValue);
-        } else if (args.at(i) == "--add-multiline-entry") {
-            QTextEdit *lastTextEdit;
-            fl->addRow(NEXT_ARG, lastWidget = lastEntry = lastTextEdit = new QTextEdit(dlg));
-            lastTextEdit->setText(lastEntryValue);
-            lastTextEdit->setPlaceholderText(lastEntryValue);
-        } else if (args.at(i) == "--entry-value") {
-            lastEntryValue = NEXT_ARG;
-            if (lastEntry) {
-                if (QLineEdit *lastLineEdit = qobject_cast<QLineEdit*>(lastEntry)) {
-                    lastLineEdit->setText(lastEntryValue);
-                    lastLineEdit->setPlaceholderText(lastEntryValue);
-                }
-                else if (QTextEdit *lastTextEdit = qobject_cast<QTextEdit*>(lastEntry)) {
-                    lastTextEdit->setText(lastEntryValue);
-                    lastTextEdit->setPlaceholderText(lastEntryValue);
-                }
-                lastEntryValue.clear();
-                lastEntry = nullptr;
-            }
-        } else if (args.at(i) == "--add-password") {
-            QLineEdit *le;
-            fl->addRow(NEXT_ARG, lastWidget = le = new QLineEdit(dlg));
-            le->setEchoMode(QLineEdit::Password);
-        } else if (args.at(i) == "--add-calendar") {
-            fl->addRow(NEXT_ARG, lastWidget = new QCalendarWidget(dlg));
-        } else if (args.at(i) == "--add-list") {
-            buildList(&lastList, lastListValues, lastListColumns, lastListHeader);
-            fl->addRow(NEXT_ARG, lastWidget = lastList = new QTreeWidget(dlg));
-        } else if (args.at(i) == "--list-values") {
-            lastListValues = NEXT_ARG.split('|');
-        } else if (args.at(i) == "--column-values") {
-            lastListColumns = NEXT_ARG.split('|');
-        } else if (args.at(i) == "--add-combo") {
-            fl->addRow(NEXT_ARG, lastWidget = lastCombo4V = lastCombo = new QComboBox(dlg));
-            lastCombo->addItems(lastComboValues);
-            lastComboValues.clear();
-        } else if (args.at(i) == "--combo-values") {
-            lastComboValues = NEXT_ARG.split('|');
-            if (lastCombo4V) {
-                lastCombo4V->addItems(lastComboValues);
-                lastComboValues.clear();
-                lastCombo4V = nullptr;
-            }
-        } else if (args.at(i) == "--combo-default") {
-            if (lastCombo) {
-                lastCombo->setCurrentText(NEXT_ARG);
-            }
-        } else if (args.at(i) == "--combo-free-entry") {
-            if (lastCombo) {
-                lastCombo->setEditable(true);
-            }
-        } else if (args.at(i) == "--show-header") {
-            lastListHeader = true;
-        } else if (args.at(i) == "--text") {
-            label->setText(labelText(NEXT_ARG));
-        } else if (args.at(i) == "--separator") {
-            dlg->setProperty("qarma_separator", NEXT_ARG);
-        } else if (args.at(i) == "--forms-date-format") {
-            dlg->setProperty("qarma_date_format", NEXT_ARG);
-        } else if (args.at(i) == "--add-checkbox") {
-            fl->addRow(lastWidget = new QCheckBox(NEXT_ARG, dlg));
-        } else if (args.at(i) == "--tooltip") {
-            const QString tip = NEXT_ARG;
-            if (lastWidget) {
-                lastWidget->setToolTip(tip);
-                lastWidget = nullptr;
-            }
-        } else { WARN_UNKNOWN_ARG("--forms") }
+        switch (const Opt id = readOption<FormsOptions>(args, i, value)) {
+            case Opt::Progressive:
+                progressive = true;
+                break;
+            case Opt::FormsFile:
+                // expanded in place, so --progressive builds the file's fields in batches as well
+                if (!readFormsFile(value, fields))
+                    return !error("--forms-file " + value + " cannot be read");
+                break;
+            case Opt::ListValues:
+            case Opt::ColumnValues:
+            case Opt::ComboValues:
+                fields << FormField{id, QString(), value.split('|')};
+                break;
+            case Opt::Unhandled:
+                WARN_UNKNOWN_ARG
+                break;
+            default:
+                fields << FormField{id, value, QStringList()};
+        }
     }
-    buildList(&lastList, lastListValues, lastListColumns, lastListHeader);
-
+    auto addField = [=](const FormField &field) {
+        if (field.id == Opt::ListValues || field.id == Opt::ColumnValues || field.id == Opt::ComboValues)
+            form->setValues(field.id, field.values);
+        else
+            form->add(field.id, field.id == Opt::Text ? labelText(field.value) : field.value);
+    };
 
     FINISH_DIALOG(QDialogButtonBox::Ok|QDialogButtonBox::Cancel);
+    if (progressive) {
+        int next = 0;
+        new Populator(dlg, btns->button(QDialogButtonBox::Ok), [=]() mutable {
+            for (const int end = qMin(next + 64, fields.count()); next < end; ++next)
+                addField(fields.at(next));
+            return next < fields.count();
+        }, [=]() { form->finish(); });
+    } else {
+        for (const FormField &field : fields)
+            addField(field);
+        form->finish();
+    }
     SHOW_DIALOG
     return 0;
 }
 
-static QFont xftFont(const QString &pattern)
+/*  One field per line, the option name w/o the dashes, a tab and the value - lists and combos take
+    all the tab separated values. \n, \t and \\ can be escaped, empty lines and #comments are skipped
+    add-combo	Fruit
+    combo-values	Apple	Banana	Cherry */
+bool Qarma::readFormsFile(const QString &path, QList<FormField> &fields)
 {
-    QFont font;
-    if (pattern.isEmpty())
-        return font;
-    /*
-    plausible subset of https://keithp.com/~keithp/render/Xft.tutorial 
-    <family>-<size>:<name>=<value>...
-    */
-    const QStringList fields = pattern.split(':');
-    bool ok = false;
-    int size = -1;
-    const int split = fields.at(0).lastIndexOf('-');
-    if (split > 0) size = fields.at(0).mid(split + 1).toUInt(&ok);
-    font = ok ? QFont(fields.at(0).mid(0, split), size) : QFont(fields.at(0));
-    
-    for (int i = 1; i < fields.count(); ++i) {
-        if (fields.at(i) == "light") font.setWeight(QFont::Light);
-        else if (fields.at(i) == "medium") font.setWeight(QFont::Medium);
-        else if (fields.at(i) == "demibold") font.setWeight(QFont::DemiBold);
-        else if (fields.at(i) == "bold") font.setWeight(QFont::Bold);
-        else if (fields.at(i) == "black") font.setWeight(QFont::Black);
-        else if (fields.at(i) == "roman") font.setItalic(false);
-        else if (fields.at(i) == "italic") font.setItalic(true);
-        else if (fields.at(i) == "oblique") font.setItalic(true);
-        else if (fields.at(i).contains('=')) {
-            QStringList field = fields.at(i).split('=');
-            if (field.count() < 2) continue;
-            if (field.at(0) == "family") font.setFamily(field.at(1));
-            else if (field.at(0) == "weight") font.setWeight(QFont::Weight(field.at(1).toUInt()));
-            else if (field.at(0) == "size") font.setPointSizeF(field.at(1).toFloat());
-            else if (field.at(0) == "pixelsize") font.setPixelSize(field.at(1).toUInt());
-            else if (field.at(0) == "slant") {
-                if (field.at(0) == "italic" || field.at(0) == "oblique")
-                    font.setItalic(true);
+    TRACE_SPAN("read forms file");
+    QFile file;
+    const QByteArray data = mapInput(path, &file);
+    if (data.isNull())
+        return false;
+    const char *c = data.constData(), *end = c + data.size();
+    for (int line = 1; c < end; ++line) {
+        const char *eol = static_cast<const char*>(memchr(c, '\n', end - c));
+        if (!eol)
+            eol = end;
+        const char *lineEnd = eol;
+        if (lineEnd > c && lineEnd[-1] == '\r') // CRLF files
+            --lineEnd;
+        const char *tab = static_cast<const char*>(memchr(c, '\t', lineEnd - c));
+        const char *keyEnd = tab ? tab : lineEnd;
+        if (keyEnd > c && *c != '#') {
+            const Option *option = findOption<FormsOptions>("--" + QString::fromLatin1(c, keyEnd - c));
+            const Opt id = option ? option->id : Opt::Unhandled;
+            if (id == Opt::ListValues || id == Opt::ColumnValues || id == Opt::ComboValues) {
+                QStringList values;
+                for (const char *field = tab; field && field < lineEnd; ) {
+                    const char *next = static_cast<const char*>(memchr(++field, '\t', lineEnd - field));
+                    values << unescaped(field, next ? next : lineEnd);
+                    field = next;
+                }
+                fields << FormField{id, QString(), values};
+            } else if (id == Opt::Unhandled || id == Opt::FormsFile || (option->takesValue && !tab)) {
+                qWarning("%s:%d: cannot use \"%s\"", qPrintable(path), line, qPrintable(QString::fromLatin1(c, keyEnd - c)));
+            } else {
+                fields << FormField{id, tab ? unescaped(tab + 1, lineEnd) : QString(), QStringList()};
             }
         }
+        c = eol + 1;
     }
-    return font;
+    return true;
 }
 
 char Qarma::showDzen(const QStringList &args)
@@ -1884,14 +2307,15 @@ char Qarma::showDzen(const QStringList &args)
 //    m_popup = true;
     NEW_DIALOG
     vl->setContentsMargins(0, 0, 0, 0);
-    QLabel *header, *body;
-    vl->addWidget(header = new QLabel(dlg));
+    DzenView *header, *body;
+    vl->addWidget(header = new DzenView(dlg));
     header->setObjectName("header");
     header->setAlignment(Qt::AlignCenter);
     header->setMargin(6);
-    vl->addWidget(body = new QLabel(dlg));
+    vl->addWidget(body = new DzenView(dlg));
     body->setObjectName("body");
     body->setMargin(8);
+    bool haveBody = false;
    
     
     QPalette pal = dlg->palette();
@@ -1900,59 +2324,82 @@ char Qarma::showDzen(const QStringList &args)
 
     int suicide = 0;
 
+    QString value;
     for (int i = 0; i < args.count(); ++i) {
-        if (args.at(i) == "-fg") {
-            QColor c(NEXT_ARG);
-            for (int i = 0; i < 3; ++i) { // Disabled, Active, Inactive, Normal
-                QPalette::ColorGroup cg = (QPalette::ColorGroup)i;
-                pal.setColor(cg, QPalette::Text, c);
-                pal.setColor(cg, QPalette::WindowText, c);
+        const Opt id = readOption<DzenOptions>(args, i, value);
+        switch (id) {
+            case Opt::Foreground: {
+                QColor c(value);
+                for (int i = 0; i < 3; ++i) { // Disabled, Active, Inactive, Normal
+                    QPalette::ColorGroup cg = (QPalette::ColorGroup)i;
+                    pal.setColor(cg, QPalette::Text, c);
+                    pal.setColor(cg, QPalette::WindowText, c);
+                }
+                break;
             }
-        } else if (args.at(i) == "-bg") {
-            QColor c(NEXT_ARG);
-            for (int i = 0; i < 3; ++i) { // Disabled, Active, Inactive, Normal
-                QPalette::ColorGroup cg = (QPalette::ColorGroup)i;
-                pal.setColor(cg, QPalette::Base, c);
-                pal.setColor(cg, QPalette::Window, c);
+            case Opt::Background: {
+                QColor c(value);
+                for (int i = 0; i < 3; ++i) { // Disabled, Active, Inactive, Normal
+                    QPalette::ColorGroup cg = (QPalette::ColorGroup)i;
+                    pal.setColor(cg, QPalette::Base, c);
+                    pal.setColor(cg, QPalette::Window, c);
+                }
+                break;
             }
-        } else if (args.at(i) == "-fn") {
-            dlg->setFont(xftFont(NEXT_ARG));
-        } else if (args.at(i) == "-ta" || args.at(i) == "-sa") {
-            QLabel *label = args.at(i) == "-sa" ? body : header;
-            QString align = NEXT_ARG;
-            if (align.startsWith('l', Qt::CaseInsensitive))
-                label->setAlignment(Qt::AlignLeft|Qt::AlignVCenter);
-            else if (align.startsWith('c', Qt::CaseInsensitive))
-                label->setAlignment(Qt::AlignCenter);
-            else if (align.startsWith('r', Qt::CaseInsensitive))
-                label->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
-        } else if (args.at(i) == "-l") {
-            READ_INT(lines, UInt, "-l(ines) expects a positive integer as next value");
-            body->setProperty("lines", lines);
-        } else if (args.at(i) == "-x") {
-            READ_INT(x, Int, "-x expects a positive integer as next value");
-            m_pos.setX(x);
-        } else if (args.at(i) == "-y") {
-            READ_INT(y, Int, "-y expects a positive integer as next value");
-            m_pos.setY(y);
-        } else if (args.at(i) == "-w") {
-            READ_INT(w, UInt, "-w expects a positive integer as next value");
-            m_size.setWidth(w);
-        } else if (args.at(i) == "-p") {
-            suicide = -1;
-            if (i+1 < args.count()) {
-                bool ok;
-                suicide = QString(args.at(i+1)).toUInt(&ok);
-                if (ok)
-                    ++i;
-                else
-                    suicide = -1;
+            case Opt::FontName:
+                dlg->setFont(xftFont(value));
+                break;
+            case Opt::TitleAlign:
+            case Opt::SlaveAlign: {
+                DzenView *view = id == Opt::SlaveAlign ? body : header;
+                if (value.startsWith('l', Qt::CaseInsensitive))
+                    view->setAlignment(Qt::AlignLeft|Qt::AlignVCenter);
+                else if (value.startsWith('c', Qt::CaseInsensitive))
+                    view->setAlignment(Qt::AlignCenter);
+                else if (value.startsWith('r', Qt::CaseInsensitive))
+                    view->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
+                break;
+            }
+            case Opt::Lines: {
+                READ_INT(lines, UInt, "-l(ines) expects a positive integer as next value");
+                body->setLineCount(lines);
+                haveBody = true;
+                break;
+            }
+            case Opt::X: {
+                READ_INT(x, Int, "-x expects a positive integer as next value");
+                m_pos.setX(x);
+                break;
             }
-        } else if (args.at(i) == "-u") {
-            dlg->setProperty("unified", true);
-        } else { WARN_UNKNOWN_ARG("--dzen") }
+            case Opt::Y: {
+                READ_INT(y, Int, "-y expects a positive integer as next value");
+                m_pos.setY(y);
+                break;
+            }
+            case Opt::W: {
+                READ_INT(w, UInt, "-w expects a positive integer as next value");
+                m_size.setWidth(w);
+                break;
+            }
+            case Opt::Persist: // the timeout is optional, so it's not in the table as value
+                suicide = -1;
+                if (i+1 < args.count()) {
+                    bool ok;
+                    suicide = QString(args.at(i+1)).toUInt(&ok);
+                    if (ok)
+                        ++i;
+                    else
+                        suicide = -1;
+                }
+                break;
+            case Opt::Unified:
+                dlg->setProperty("unified", true);
+                break;
+            default:
+                WARN_UNKNOWN_ARG
+        }
     }
-    if (!body->property("lines").isValid())
+    if (!haveBody)
         delete body;
     dlg->setPalette(pal);
 //       62     -tw     title window width
@@ -1973,277 +2420,89 @@ char Qarma::showDzen(const QStringList &args)
 
 QString Qarma::labelText(const QString &s) const
 {
-    // zenity uses pango markup, https://developer.gnome.org/pygtk/stable/pango-markup-language.html
-    // This near-html-subset isn't really compatible w/ Qt's html subset and we end up
-    // w/ a weird mix of ASCII escape codes and html tags
-    // the below is NOT a perfect translation
-
-    // known "caveats"
-    // pango termiantes the string for "\0" (we do not - atm)
-    // pango inserts some control char for "\f", but that's not reasonably handled by gtk label (so it's ignored here)
-    if (m_zenity) {
-        QString r = s;
-        // First replace backslashes with alarms to avoid false positives below.
-        // The alarm is treated as invalid and not supported by zenity/pango either
-        r.replace("\\\\", "\a") \
-         .replace("\\n", "<br>").replace("\\t", "&nbsp;&nbsp;&nbsp;") \
-         .replace("\\r", "<br>");
-        int idx = 0;
-        while (true) {
-            static const QRegularExpression octet("\\\\([0-9]{1,3})");
-            idx = r.indexOf(octet, idx);
-            if (idx < 0)
-                break;
-            int sz = 0;
-            while (sz < 3 && r.at(idx+sz+1).isDigit())
-                ++sz;
-            r.replace(idx, sz+1, QChar(r.mid(idx+1, sz).toUInt(nullptr, 8)));
-        }
-        r.remove("\\").replace(("\a"), "\\");
-        return r;
-    }
-    return s;
+    // progress dialogs tend to repeat the same few labels over and over
+    // zenity and qarma mode translate the same markup differently
+    static QCache<QString, QString> cache(64);
+    const QString key = QLatin1Char(m_zenity ? 'z' : 'q') + s;
+    if (const QString *hit = cache.object(key))
+        return *hit;
+    const QString r = pangoToRichText(s, m_zenity);
+    cache.insert(key, new QString(r));
+    return r;
 }
 
 
-void Qarma::printHelp(const QString &category)
+static void printCategory(const OptionTable &table)
 {
-    static HelpDict helpDict;
-    if (helpDict.isEmpty()) {
-        helpDict["help"] = CategoryHelp(tr("Help options"), HelpList() <<
-                            Help("-h, --help", tr("Show help options")) <<
-                            Help("--help-all", tr("Show all help options")) <<
-                            Help("--help-general", tr("Show general options")) <<
-                            Help("--help-calendar", tr("Show calendar options")) <<
-                            Help("--help-entry", tr("Show text entry options")) <<
-                            Help("--help-error", tr("Show error options")) <<
-                            Help("--help-info", tr("Show info options")) <<
-                            Help("--help-file-selection", tr("Show file selection options")) <<
-                            Help("--help-list", tr("Show list options")) <<
-                            Help("--help-notification", tr("Show notification icon options")) <<
-                            Help("--help-progress", tr("Show progress options")) <<
-                            Help("--help-question", tr("Show question options")) <<
-                            Help("--help-warning", tr("Show warning options")) <<
-                            Help("--help-scale", tr("Show scale options")) <<
-                            Help("--help-text-info", tr("Show text information options")) <<
-                            Help("--help-color-selection", tr("Show color selection options")) <<
-                            Help("--help-font-selection", tr("Show font selection options")) <<
-                            Help("--help-password", tr("Show password dialog options")) <<
-                            Help("--help-forms", tr("Show forms dialog options")) <<
-                            Help("--help-dzen", tr("Show dzen options")) <<
-                            Help("--help-misc", tr("Show miscellaneous options")) <<
-                            Help("--help-qt", tr("Show Qt Options")));
-        helpDict["general"] = CategoryHelp(tr("General options"), HelpList() <<
-                            Help("--title=TITLE", tr("Set the dialog title")) <<
-                            Help("--window-icon=ICONPATH", tr("Set the window icon")) <<
-                            Help("--width=WIDTH", tr("Set the width") + tr(" (not entirely deterministic for message dialogs)")) <<
-                            Help("--height=HEIGHT", tr("Set the height") + tr(" (not entirely deterministic for message dialogs)")) <<
-                            Help("--pos=[+-]x[(+-)y]", "QARMA ONLY! " + tr("Set the position")) <<
-                            Help("--timeout=TIMEOUT", tr("Set dialog timeout in seconds")) <<
-                            Help("--ok-label=TEXT", tr("Sets the label of the Ok button")) <<
-                            Help("--cancel-label=TEXT", tr("Sets the label of the Cancel button")) <<
-                            Help("--modal", tr("Set the modal hint")) <<
-                            Help("--popup", "QARMA ONLY! " + tr("Open dialog as unframed and trasient popup window")) <<
-                            Help("--attach=WINDOW", tr("Set the parent window to attach to")));
-        helpDict["calendar"] = CategoryHelp(tr("Calendar options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--day=DAY", tr("Set the calendar day")) <<
-                            Help("--month=MONTH", tr("Set the calendar month")) <<
-                            Help("--year=YEAR", tr("Set the calendar year")) <<
-                            Help("--timeout=TIMEOUT", tr("Set dialog timeout in seconds")) <<
-                            Help("--date-format=PATTERN", tr("Set the format for the returned date")));
-        helpDict["entry"] = CategoryHelp(tr("Text entry options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--entry-text=TEXT", tr("Set the entry text")) <<
-                            Help("--hide-text", tr("Hide the entry text")) <<
-                            Help("--values=v1|v2|v3|...", "QARMA ONLY! " + tr("Offer preset values to pick from")) <<
-                            Help("--int=integer", "QARMA ONLY! " + tr("Integer input only, preset given value")) <<
-                            Help("--float=floating_point", "QARMA ONLY! " + tr("Floating point input only, preset given value")));
-        helpDict["error"] = CategoryHelp(tr("Error options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--icon-name=ICON-NAME", tr("Set the dialog icon")) <<
-                            Help("--no-wrap", tr("Do not enable text wrapping")) <<
-                            Help("--no-markup", tr("Do not enable html markup")) <<
-                            Help("--ellipsize", tr("Do wrap text, zenity has a rather special problem here")) <<
-                            Help("--selectable-labels", "QARMA ONLY! " + tr("Allow to select text for copy and paste")));
-        helpDict["info"] = CategoryHelp(tr("Info options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--icon-name=ICON-NAME", tr("Set the dialog icon")) <<
-                            Help("--no-wrap", tr("Do not enable text wrapping")) <<
-                            Help("--no-markup", tr("Do not enable html markup")) <<
-                            Help("--ellipsize", tr("Do wrap text, zenity has a rather special problem here")) <<
-                            Help("--selectable-labels", "QARMA ONLY! " + tr("Allow to select text for copy and paste")));
-        helpDict["file-selection"] = CategoryHelp(tr("File selection options"), HelpList() <<
-                            Help("--filename=FILENAME", tr("Set the filename")) <<
-                            Help("--multiple", tr("Allow multiple files to be selected")) <<
-                            Help("--directory", tr("Activate directory-only selection")) <<
-                            Help("--save", tr("Activate save mode")) <<
-                            Help("--separator=SEPARATOR", tr("Set output separator character")) <<
-                            Help("--confirm-overwrite", tr("Confirm file selection if filename already exists")) <<
-                            Help("--file-filter=NAME | PATTERN1 PATTERN2 ...", tr("Sets a filename filter")) <<
-                            Help("--preview-images=SIZE", "QARMA ONLY! " + tr("Show image thumbnails of SIZE")));
-        helpDict["list"] = CategoryHelp(tr("List Command\n  %1 --list [Options] [Item1 ...]\nList Options").arg(applicationName()), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--column=COLUMN", tr("Set the column header")) <<
-                            Help("--checklist", tr("Use check boxes for first column")) <<
-                            Help("--radiolist", tr("Use radio buttons for first column")) <<
-                            Help("--imagelist", tr("Use an image for first column")) <<
-                            Help("--separator=SEPARATOR", tr("Set output separator character")) <<
-                            Help("--multiple", tr("Allow multiple rows to be selected")) <<
-                            Help("--editable", tr("Allow changes to text")) <<
-                            Help("--print-column=NUMBER", tr("Print a specific column (Default is 1. 'ALL' can be used to print all columns)")) <<
-                            Help("--hide-column=NUMBER", tr("Hide a specific column")) <<
-                            Help("--hide-header", tr("Hides the column headers")) <<
-                            Help("--mid-search", tr("Change list default search function searching for text in the middle, not on the beginning")));
-        helpDict["notification"] = CategoryHelp(tr("Notification icon options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--listen", tr("Listen for commands on stdin")) <<
-                            Help("--hint=TEXT", tr("Set the notification hints")) <<
-                            Help("--selectable-labels", "QARMA ONLY! " + tr("Allow to select text for copy and paste")));
-        helpDict["progress"] = CategoryHelp(tr("Progress options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--percentage=PERCENTAGE", tr("Set initial percentage")) <<
-                            Help("--pulsate", tr("Pulsate progress bar")) <<
-                            Help("--auto-close", tr("Dismiss the dialog when 100% has been reached")) <<
-                            Help("--auto-kill", tr("Kill parent process if Cancel button is pressed")) <<
-                            Help("--no-cancel", tr("Hide Cancel button")));
-        helpDict["question"] = CategoryHelp(tr("Question options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--icon-name=ICON-NAME", tr("Set the dialog icon")) <<
-                            Help("--no-wrap", tr("Do not enable text wrapping")) <<
-                            Help("--no-markup", tr("Do not enable html markup")) <<
-                            Help("--default-cancel", tr("Give cancel button focus by default")) <<
-                            Help("--ellipsize", tr("Do wrap text, zenity has a rather special problem here")) <<
-                            Help("--selectable-labels", "QARMA ONLY! " + tr("Allow to select text for copy and paste")));
-        helpDict["warning"] = CategoryHelp(tr("Warning options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--icon-name=ICON-NAME", tr("Set the dialog icon")) <<
-                            Help("--no-wrap", tr("Do not enable text wrapping")) <<
-                            Help("--no-markup", tr("Do not enable html markup")) <<
-                            Help("--ellipsize", tr("Do wrap text, zenity has a rather special problem here")) <<
-                            Help("--selectable-labels", "QARMA ONLY! " + tr("Allow to select text for copy and paste")));
-        helpDict["scale"] = CategoryHelp(tr("Scale options"), HelpList() <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--value=VALUE", tr("Set initial value")) <<
-                            Help("--min-value=VALUE", tr("Set minimum value")) <<
-                            Help("--max-value=VALUE", tr("Set maximum value")) <<
-                            Help("--step=VALUE", tr("Set step size")) <<
-                            Help("--print-partial", tr("Print partial values")) <<
-                            Help("--hide-value", tr("Hide value")));
-        helpDict["text-info"] = CategoryHelp(tr("Text information options"), HelpList() <<
-                            Help("--filename=FILENAME", tr("Open file")) <<
-                            Help("--editable", tr("Allow changes to text")) <<
-                            Help("--font=TEXT", tr("Set the text font")) <<
-                            Help("--checkbox=TEXT", tr("Enable an I read and agree checkbox")) <<
-                            Help("--plain", "QARMA ONLY! " + tr("Force plain text, zenity default limitation")) <<
-                            Help("--html", tr("Enable HTML support")) <<
-                            Help("--no-interaction", tr("Do not enable user interaction with the WebView. Only works if you use --html option")) <<
-                            Help("--url=URL", "REQUIRES CURL BINARY! " + tr("Set an URL instead of a file. Only works if you use --html option")) <<
-                            Help("--auto-scroll", tr("Auto scroll the text to the end. Only when text is captured from stdin")));
-        helpDict["color-selection"] = CategoryHelp(tr("Color selection options"), HelpList() <<
-                            Help("--color=VALUE", tr("Set the color")) <<
-                            Help("--show-palette", tr("Show the palette")) <<
-                            Help("--custom-palette=path/to/some.gpl",  "QARMA ONLY! " + tr("Load a custom GPL for standard colors")));
-        helpDict["font-selection"] = CategoryHelp(tr("Font selection options"), HelpList() <<
-                            Help("--type=[vector][,bitmap][,fixed][,variable]", tr("Filter fonts (default: all)")) <<
-                            Help("--pattern=%1-%2:%3:%4", tr("Output pattern, %1: Name, %2: Size, %3: weight, %4: slant")) <<
-                            Help("--sample=TEXT", tr("Sample text, defaults to the foxdogthing")));
-        helpDict["password"] = CategoryHelp(tr("Password dialog options"), HelpList() <<
-                            Help("--username", tr("Display the username option")) <<
-                            Help("--prompt=TEXT", "QARMA ONLY! " + tr("The prompt for the user")));
-        helpDict["forms"] = CategoryHelp(tr("Forms dialog options"), HelpList() <<
-                            Help("--add-entry=Field name", tr("Add a new Entry in forms dialog")) <<
-                            Help("--add-multiline-entry=Field name", tr("Add a new multiline Entry in forms dialog")) <<
-                            Help("--entry-value=TEXT", "QARMA ONLY! " + tr("Preset text for the last entry")) <<
-                            Help("--add-password=Field name", tr("Add a new Password Entry in forms dialog")) <<
-                            Help("--add-calendar=Calendar field name", tr("Add a new Calendar in forms dialog")) <<
-                            Help("--add-list=List field and header name", tr("Add a new List in forms dialog")) <<
-                            Help("--list-values=List of values separated by |", tr("List of values for List")) <<
-                            Help("--column-values=List of values separated by |", tr("List of values for columns")) <<
-                            Help("--add-combo=Combo box field name", tr("Add a new combo box in forms dialog")) <<
-                            Help("--combo-values=List of values separated by |", tr("List of values for combo box")) <<
-                            Help("--combo-default=Value", "QARMA ONLY! " + tr("The default value of the last added combo box")) <<
-                            Help("--combo-free-entry", "QARMA ONLY! " + tr("Allow to enter values not in the list the last added combo box")) <<
-                            Help("--show-header", tr("Show the columns header")) <<
-                            Help("--tooltip=ToolTip", "QARMA ONLY! " + tr("Add a tooltip to the previous element")) <<
-                            Help("--text=TEXT", tr("Set the dialog text")) <<
-                            Help("--separator=SEPARATOR", tr("Set output separator character")) <<
-                            Help("--forms-date-format=PATTERN", tr("Set the format for the returned date")) <<
-                            Help("--add-checkbox=Checkbox label", "QARMA ONLY! " + tr("Add a new Checkbox forms dialog")));
-        helpDict["dzen"] =  CategoryHelp(tr("Dzen options"), HelpList() <<
-                            Help("-fg <color>", tr("Set foreground color. Either as symbolic name (e.g. red, darkgreen, etc.) or as #rrggbb hex-value.")) <<
-                            Help("-bg <color>", tr("Set background color (same format as -fg).")) <<
-                            Help("-fn <font>", tr("Set font (using the format of xlsfonts and xfontsel).")) <<
-                            Help("-ta <l|c|r>", tr("Set alignement of title window content: l(eft), c(center) or r(ight).")) <<
-                            Help("-sa <l|c|r>", tr("Set alignment of slave window (see -ta ).")) <<
-                            Help("-l <lines>", tr("Number of lines to display in slave window.")) <<
-                            Help("-u", tr("Update contents of title and slave window simultaneously.")) <<
-                            Help("-p [<timeout>]", tr("Persist EOF (optional timeout in seconds).")) <<
-                            Help("-x <pixels>", tr("Set x position on the screen.")) <<
-                            Help("-y <pixels>", tr("Set y position on the screen.")) <<
-                            Help("-w <pixels>", tr("width")));
-        helpDict["misc"] = CategoryHelp(tr("Miscellaneous options"), HelpList() <<
-                            Help("--about", tr("About Qarma")) <<
-                            Help("--version", tr("Print version")));
-        helpDict["qt"] = CategoryHelp(tr("Qt options"), HelpList() <<
-                            Help("-platform <platformName[:options]>", tr("specifies the Qt Platform Abstraction (QPA) plugin")) <<
-                            Help("-platformpluginpath <path>", tr("specifies the path to platform plugins")) <<
-                            Help("-platformtheme <platformTheme>", tr("specifies the platform theme")) <<
-                            Help("-plugin <plugin>", tr("specifies additional plugins to load. Can appear multiple times")) <<
-                            Help("-qwindowgeometry <WxH+X+Y>", tr("specifies window geometry for the main window")) <<
-                            Help("-qwindowicon <icon>", tr("sets the default window icon")) <<
-                            Help("-qwindowtitle <title>", tr("sets the title of the first window")) <<
-                            Help("-reverse", tr("sets the application's layout direction to Qt::RightToLeft")) <<
-                            Help("-display <hostname:screen_number>", tr("switches displays on X11")) <<
-                            Help("-geometry <WxH+X+Y>", tr("same as -qwindowgeometry")));
-        helpDict["application"] = CategoryHelp(tr("Application Options"), HelpList() <<
-                            Help("--calendar", tr("Display calendar dialog")) <<
-                            Help("--entry", tr("Display text entry dialog")) <<
-                            Help("--error", tr("Display error dialog")) <<
-                            Help("--info", tr("Display info dialog")) <<
-                            Help("--file-selection", tr("Display file selection dialog")) <<
-                            Help("--list", tr("Display list dialog")) <<
-                            Help("--notification", tr("Display notification")) <<
-                            Help("--progress", tr("Display progress indication dialog")) <<
-                            Help("--question", tr("Display question dialog")) <<
-                            Help("--warning", tr("Display warning dialog")) <<
-                            Help("--scale", tr("Display scale dialog")) <<
-                            Help("--text-info", tr("Display text information dialog")) <<
-                            Help("--color-selection", tr("Display color selection dialog")) <<
-                            Help("--font-selection", "QARMA ONLY! " + tr("Display font selection dialog")) <<
-                            Help("--password", tr("Display password dialog")) <<
-                            Help("--forms", tr("Display forms dialog")) <<
-                            Help("--dzen", "QARMA ONLY! " + tr("Somewhat dzen compatible label")) <<
-                            Help("--display=DISPLAY", tr("X display to use")) <<
-                            Help("--class=CLASS", tr("Program class as used by the window manager")) <<
-                            Help("--name=NAME", tr("Program name as used by the window manager")));
+    QString title = QCoreApplication::translate("Qarma", table.title);
+    if (title.contains("%1"))
+        title = title.arg(QCoreApplication::applicationName());
+    printf("%s\n", qPrintable(title));
+    for (int i = 0; i < table.count; ++i) {
+        const Option &option = table.options[i];
+        const QByteArray usage = QByteArray(option.name) + option.syntax;
+        QString help = QCoreApplication::translate("Qarma", option.help);
+        if (option.note)
+            help.prepend(QLatin1String(option.note));
+        printf("  %-53s%s\n", usage.constData(), qPrintable(help));
     }
+    printf("\n");
+}
 
+void Qarma::printHelp(const QString &category)
+{
+    const int count = sizeof(HelpCategories) / sizeof(HelpCategories[0]);
     if (category == "all") {
-        foreach(const CategoryHelp &el, helpDict) {
-            printf("%s\n", qPrintable(el.first));
-            foreach (const Help &help, el.second)
-                printf("  %-53s%s\n", qPrintable(help.first), qPrintable(help.second));
-            printf("\n");
-        }
+        for (int i = 0; i < count; ++i)
+            printCategory(HelpCategories[i]);
         return;
     }
 
-    HelpDict::const_iterator it = helpDict.constEnd();
-    if (!category.isEmpty())
-        it = helpDict.find(category);
+    for (int i = 0; i < count; ++i) {
+        if (category == QLatin1String(HelpCategories[i].category)) {
+            printCategory(HelpCategories[i]);
+            return;
+        }
+    }
 
-    if (it == helpDict.constEnd()) {
-        printf("Usage:\n  %s [OPTION ...]\n\n", qPrintable(applicationName()));
-        printHelp("help");
-        printHelp("application");
-        return;
+    printf("Usage:\n  %s [OPTION ...]\n\n", qPrintable(applicationName()));
+    printHelp("help");
+    printHelp("application");
+}
+
+#ifndef QARMA_NO_MAIN // the tests bring their own
+// strips "--name value" (or "--name" alone if the value isn't required) and "--name=value" from argv
+static bool takeOption(int &argc, char **argv, int i, const char *name, bool requiresValue, QString &value)
+{
+    const QString arg = QString::fromLocal8Bit(argv[i]);
+    int n = 0;
+    if (arg == QLatin1String(name)) {
+        n = 1;
+        if (requiresValue && i + 1 < argc) {
+            value = QString::fromLocal8Bit(argv[i+1]);
+            n = 2;
+        }
+    } else if (arg.startsWith(QString::fromLatin1(name) + '=')) {
+        value = arg.mid(qstrlen(name) + 1);
+        n = 1;
     }
+    if (!n)
+        return false;
+    for (int j = i; j + n <= argc; ++j) // also moves the terminating NULL
+        argv[j] = argv[j + n];
+    argc -= n;
+    return true;
+}
 
-    printf("%s\n", qPrintable(it->first));
-    foreach (const Help &help, it->second)
-        printf("  %-53s%s\n", qPrintable(help.first), qPrintable(help.second));
-    printf("\n");
+// whether any dialog reads the argument after arg as its value
+static bool takesValue(const QString &arg)
+{
+    for (const OptionTable &table : HelpCategories) {
+        const Option *option = findOption(table.index, table.count, arg);
+        if (option && option->takesValue)
+            return true;
+    }
+    return false;
 }
 
 int main (int argc, char **argv)
@@ -2255,6 +2514,24 @@ int main (int argc, char **argv)
         return 1;
     }
 
+    // instrumentation is none of Qt's or the dialogs business
+    for (int i = 1; i < argc; ++i) {
+        QString value;
+        if (takeOption(argc, argv, i, "--trace", true, value)) {
+            if (!value.isEmpty())
+                Trace::start(value);
+            --i;
+        } else if (takeOption(argc, argv, i, "--stats", false, value)) {
+            Stats::start(value);
+            --i;
+        } else if (takeOption(argc, argv, i, "--watchdog", false, value)) {
+            bool ok;
+            const int threshold = value.toUInt(&ok);
+            Watchdog::start(ok ? threshold : 250);
+            --i;
+        }
+    }
+
     bool helpMission = false;
     for (int i = 1; i < argc; ++i) {
         const QString arg(argv[i]);
@@ -2268,6 +2545,37 @@ int main (int argc, char **argv)
         return 0;
     }
 
+    /*  Qt sucks away "--title foo" (also --name and --display) but not "--title=foo"
+        and then stumbles over itself when trying to apply it.
+        So it gets the "=" form of the options we handle ourselves and the split
+        form of --display, that's its business.
+        QApplication keeps referring to argv, hence static */
+    static QVector<char*> qtArgs;
+    qtArgs.reserve(argc + 2);
+    for (int i = 0; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if ((arg == "--title" || arg == "--name") && i + 1 < argc) {
+            qtArgs << qstrdup((arg + '=' + argv[++i]).constData());
+        } else if (arg.startsWith("--display=")) {
+            qtArgs << qstrdup("-display") << qstrdup(arg.mid(10).constData());
+        } else {
+            qtArgs << argv[i];
+            // "--text --title" shows "--title", the value of an option is nobody's business
+            if (i > 0 && i + 1 < argc && arg.startsWith('-') && takesValue(QString::fromLocal8Bit(arg)))
+                qtArgs << argv[++i];
+        }
+    }
+    argc = qtArgs.count();
+    qtArgs << nullptr;
+    argv = qtArgs.data();
+
+    Trace::begin("QApplication init");
     Qarma d(argc, argv);
-    return d.exec();
+    listenForDumpSignal();
+    const int ret = d.exec();
+    Watchdog::stop();
+    Trace::write();
+    Stats::dump();
+    return ret;
 }
+#endif // QARMA_NO_MAIN
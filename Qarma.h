@@ -21,9 +21,11 @@
 
 class QDialog;
 class QTreeWidgetItem;
+struct FormField;
 
 #include <QApplication>
 #include <QPair>
+#include <QSet>
 
 class Qarma : public QApplication
 {
@@ -34,10 +36,12 @@ public:
                 Scale, TextInfo, ColorSelection, FontSelection, Password, Forms, Dzen };
     static void printHelp(const QString &category = QString());
     using  QApplication::notify;
+    bool notify(QObject *receiver, QEvent *event) override;
 private:
     char showCalendar(const QStringList &args);
     char showEntry(const QStringList &args);
     char showPassword(const QStringList &args);
+    void showAskpass(const QString &prompt);
 
     char showMessage(const QStringList &args, char type);
 
@@ -50,8 +54,10 @@ private:
     char showColorSelection(const QStringList &args);
     char showFontSelection(const QStringList &args);
     char showForms(const QStringList &args);
+    bool readFormsFile(const QString &path, QList<FormField> &fields);
     char showDzen(const QStringList &args);
     bool readGeneral(QStringList &args);
+    void setupDialog(); // the shortcuts and general options every dialog gets
     bool error(const QString message);
     void listenToStdIn();
     void notify(const QString message, bool noClose = false);
@@ -64,14 +70,15 @@ private slots:
     void readStdIn();
     void toggleItems(QTreeWidgetItem *item, int column);
     void finishProgress();
+    void countDBusCall();
 private:
     bool m_helpMission, m_modal, m_zenity, m_selectableLabel, m_popup;
     QString m_caption, m_icon, m_ok, m_cancel, m_notificationHints, m_class, m_name;
     QSize m_size;
     QPoint m_pos;
     int m_parentWindow, m_timeout;
-    uint m_notificationId;
     QDialog *m_dialog;
+    QSet<QTreeWidgetItem*> m_checkedItems;
     Type m_type;
 };
 
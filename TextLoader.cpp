@@ -0,0 +1,197 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "TextLoader.h"
+#include "Instrumentation.h"
+
+#include <QIODevice>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTextEdit>
+#include <QTimer>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <QStringDecoder>
+#else
+#include <QTextCodec>
+#endif
+
+#include <cctype>
+
+TextLoader::TextLoader(QIODevice *source, QTextEdit *te, Format format, const std::function<QByteArray()> &contentType)
+: QObject(te)
+, m_source(source)
+, m_text(te)
+, m_format(format)
+, m_contentType(contentType)
+, m_render(new QTimer(this))
+, m_finished(false)
+, m_aborted(false)
+{
+    m_render->setSingleShot(true);
+    m_render->setInterval(250);
+    connect(m_render, &QTimer::timeout, this, &TextLoader::render);
+    connect(source, &QIODevice::readyRead, this, &TextLoader::read);
+    connect(source, &QIODevice::readChannelFinished, this, &TextLoader::finish);
+}
+
+TextLoader::~TextLoader()
+{
+}
+
+QByteArray TextLoader::charset(const QByteArray &contentType)
+{
+    const QList<QByteArray> parameters = contentType.split(';');
+    for (int i = 1; i < parameters.count(); ++i) {
+        const QByteArray parameter = parameters.at(i).trimmed();
+        if (parameter.toLower().startsWith("charset=")) {
+            QByteArray name = parameter.mid(8).trimmed();
+            if (name.size() > 1 && (name.startsWith('"') || name.startsWith('\'')) && name.endsWith(name.at(0)))
+                name = name.mid(1, name.size() - 2);
+            return name;
+        }
+    }
+    return QByteArray();
+}
+
+QByteArray TextLoader::htmlCharset(const QByteArray &head)
+{
+    const QByteArray lower = head.toLower();
+    for (int meta = lower.indexOf("<meta"); meta > -1; meta = lower.indexOf("<meta", meta + 5)) {
+        const int end = lower.indexOf('>', meta);
+        int i = lower.indexOf("charset", meta);
+        if (i < 0 || (end > -1 && i > end))
+            continue;
+        // charset="utf-8" or content="text/html; charset=utf-8"
+        i += 7;
+        while (i < lower.size() && (lower.at(i) == ' ' || lower.at(i) == '=' || lower.at(i) == '"' || lower.at(i) == '\''))
+            ++i;
+        int j = i;
+        while (j < lower.size() && (isalnum(uchar(lower.at(j))) || lower.at(j) == '-' || lower.at(j) == '_' || lower.at(j) == '.' || lower.at(j) == ':'))
+            ++j;
+        if (j > i)
+            return head.mid(i, j - i);
+    }
+    return QByteArray();
+}
+
+void TextLoader::sourceProgress(qint64 received, qint64 total)
+{
+    emit progress(total > 0 ? int(received * 1000 / total) : -1);
+}
+
+void TextLoader::abort()
+{
+    m_aborted = true;
+    finish();
+}
+
+void TextLoader::read()
+{
+    const QByteArray chunk = m_source->readAll();
+    if (chunk.isEmpty())
+        return;
+    Stats::input(chunk);
+    Stats::update();
+    if (m_decoder) {
+        append(decode(chunk));
+        return;
+    }
+    m_head += chunk;
+    if (m_head.size() >= 1024) // the <meta> is supposed to be in the first kilobyte
+        start();
+}
+
+// the charset and whether it's html, from what's there once there's enough of it
+void TextLoader::start()
+{
+    const QByteArray contentType = m_contentType ? m_contentType() : QByteArray();
+    const QByteArray mime = contentType.split(';').first().trimmed().toLower();
+    const bool html = mime == "text/html" || mime == "application/xhtml+xml";
+    QByteArray name = charset(contentType);
+    if (name.isEmpty() && m_format != PlainText && (html || mime.isEmpty() || m_format == RichText))
+        name = htmlCharset(m_head);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    if (!name.isEmpty())
+        m_decoder.reset(new QStringDecoder(name.constData()));
+    if (!m_decoder || !m_decoder->isValid())
+        m_decoder.reset(new QStringDecoder(QStringDecoder::System));
+#else
+    QTextCodec *codec = name.isEmpty() ? nullptr : QTextCodec::codecForName(name);
+    if (!codec)
+        codec = QTextCodec::codecForLocale();
+    m_decoder.reset(codec->makeDecoder());
+#endif
+    const QString text = decode(m_head);
+    m_head.clear();
+    if (m_format == AutoDetect)
+        m_format = (html || Qt::mightBeRichText(text)) ? RichText : PlainText;
+    append(text);
+}
+
+void TextLoader::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    if (!m_aborted) // an aborted source is closed, there's nothing left to read
+        read();
+    if (!m_decoder)
+        start();
+    if (m_render->isActive()) {
+        m_render->stop();
+        render();
+    }
+    emit finished();
+}
+
+QString TextLoader::decode(const QByteArray &ba)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return (*m_decoder)(ba);
+#else
+    return m_decoder->toUnicode(ba);
+#endif
+}
+
+void TextLoader::append(const QString &text)
+{
+    if (m_format == RichText) {
+        m_html += text;
+        if (!m_render->isActive())
+            m_render->start();
+        return;
+    }
+    // plain text is just appended, w/o touching what's there
+    QTextCursor cursor(m_text->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+    if (m_text->verticalScrollBar() && m_text->property("qarma_autoscroll").toBool())
+        m_text->verticalScrollBar()->setValue(m_text->verticalScrollBar()->maximum());
+}
+
+void TextLoader::render()
+{
+    TRACE_SPAN("render html");
+    QScrollBar *sb = m_text->verticalScrollBar();
+    const int oldValue = sb ? sb->value() : 0;
+    m_text->setHtml(m_html);
+    if (sb)
+        sb->setValue(m_text->property("qarma_autoscroll").toBool() ? sb->maximum() : oldValue);
+}
@@ -0,0 +1,82 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_TEXTLOADER_H
+#define QARMA_TEXTLOADER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include <functional>
+#include <memory>
+
+class QIODevice;
+class QTextEdit;
+class QTimer;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+class QStringDecoder;
+#else
+class QTextDecoder;
+#endif
+
+/*  Streams a QIODevice into a QTextEdit while it arrives, for --text-info --url
+    The charset comes from the Content-Type, the <meta> of html or the locale, in that order.
+    W/o --html or --plain, html is what says so in the Content-Type or looks like it, just like setText() guesses.
+    Plain text is appended w/o touching what's there, html can't be parsed in pieces and what has
+    arrived so far is rendered every now and then. */
+class TextLoader : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format { AutoDetect, PlainText, RichText };
+    // contentType is asked once the first data arrived, the source is read until its readChannelFinished()
+    TextLoader(QIODevice *source, QTextEdit *te, Format format, const std::function<QByteArray()> &contentType = nullptr);
+    ~TextLoader() override;
+    Format format() const { return m_format; }
+    static QByteArray charset(const QByteArray &contentType); // "text/html; charset=UTF-8" -> "UTF-8"
+    static QByteArray htmlCharset(const QByteArray &head); // <meta charset=…> or <meta http-equiv=… content="…; charset=…">
+public slots:
+    void sourceProgress(qint64 received, qint64 total);
+    void abort(); // before the source gets aborted, keeps what arrived so far and finishes w/o reading again
+signals:
+    void progress(int permille); // -1 as long as the total size isn't known
+    void finished();
+private:
+    void read();
+    void start();
+    void finish();
+    void append(const QString &text);
+    void render();
+    QString decode(const QByteArray &ba);
+    QIODevice *m_source;
+    QTextEdit *m_text;
+    Format m_format;
+    std::function<QByteArray()> m_contentType;
+    QByteArray m_head; // until there's enough to tell the charset
+    QString m_html;
+    QTimer *m_render;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    std::unique_ptr<QStringDecoder> m_decoder;
+#else
+    std::unique_ptr<QTextDecoder> m_decoder;
+#endif
+    bool m_finished, m_aborted;
+};
+
+#endif //QARMA_TEXTLOADER_H
@@ -0,0 +1,169 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ValueModel.h"
+#include "Instrumentation.h"
+
+#include <QComboBox>
+#include <QCompleter>
+#include <QElapsedTimer>
+#include <QLineEdit>
+#include <QTimer>
+
+static inline quint64 trigram(const QString &s, int i)
+{
+    return quint64(s.at(i).toCaseFolded().unicode()) << 32 |
+           quint64(s.at(i+1).toCaseFolded().unicode()) << 16 |
+           quint64(s.at(i+2).toCaseFolded().unicode());
+}
+
+ValueIndex::ValueIndex(const QStringList &values, QObject *parent) : QObject(parent), m_values(values), m_indexed(0)
+{
+    QTimer::singleShot(0, this, [=]() { build(); });
+}
+
+void ValueIndex::build()
+{
+    TRACE_SPAN("index values");
+    QElapsedTimer slice;
+    slice.start();
+    while (m_indexed < m_values.count()) {
+        const QString &s = m_values.at(m_indexed);
+        for (int i = 0; i + 2 < s.length(); ++i) {
+            QVector<int> &rows = m_trigrams[trigram(s, i)];
+            if (rows.isEmpty() || rows.last() != m_indexed) // values are indexed in order
+                rows << m_indexed;
+        }
+        // check the clock only every now and then, it's not free either
+        if (!(++m_indexed % 256) && slice.elapsed() > 8) {
+            QTimer::singleShot(0, this, [=]() { build(); });
+            return;
+        }
+    }
+    m_trigrams.squeeze();
+}
+
+bool ValueIndex::candidates(const QString &filter, QVector<int> *rows) const
+{
+    if (filter.length() < 3 || m_indexed < m_values.count())
+        return false;
+    // every match has all trigrams of the filter, the rarest one has the fewest false positives
+    const QVector<int> *rarest = nullptr;
+    for (int i = 0; i + 2 < filter.length(); ++i) {
+        QHash<quint64, QVector<int>>::const_iterator it = m_trigrams.constFind(trigram(filter, i));
+        if (it == m_trigrams.constEnd()) {
+            rows->clear();
+            return true;
+        }
+        if (!rarest || it->count() < rarest->count())
+            rarest = &(*it);
+    }
+    *rows = *rarest;
+    return true;
+}
+
+ValueModel::ValueModel(const ValueIndex *index, QObject *parent) : QAbstractListModel(parent), m_index(index), m_all(true), m_scanned(0)
+{
+}
+
+void ValueModel::setFilter(const QString &filter)
+{
+    beginResetModel();
+    m_filter = filter;
+    m_all = !m_index->candidates(filter, &m_candidates);
+    m_rows.clear();
+    m_scanned = 0;
+    endResetModel();
+}
+
+int ValueModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.count();
+}
+
+QVariant ValueModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.count())
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return m_index->values().at(m_rows.at(index.row()));
+    return QVariant();
+}
+
+bool ValueModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_scanned < candidateCount();
+}
+
+void ValueModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+    const QStringList &values = m_index->values();
+    const int count = candidateCount();
+    QVector<int> rows;
+    while (m_scanned < count && rows.count() < 256) {
+        const int v = m_all ? m_scanned : m_candidates.at(m_scanned);
+        ++m_scanned;
+        if (m_filter.isEmpty() || values.at(v).contains(m_filter, Qt::CaseInsensitive))
+            rows << v;
+    }
+    if (rows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), m_rows.count(), m_rows.count() + rows.count() - 1);
+    m_rows << rows;
+    endInsertRows();
+}
+
+QModelIndexList ValueModel::match(const QModelIndex &start, int role, const QVariant &value, int hits, Qt::MatchFlags flags) const
+{
+    // QComboBox::findText() - must find values that haven't been fetched yet
+    if (!m_filter.isEmpty() || start.row() != 0 || hits != 1 || (flags & Qt::MatchTypeMask) != Qt::MatchExactly ||
+        (role != Qt::DisplayRole && role != Qt::EditRole))
+        return QAbstractListModel::match(start, role, value, hits, flags);
+    const int v = m_index->values().indexOf(value.toString());
+    if (v < 0)
+        return QModelIndexList();
+    ValueModel *that = const_cast<ValueModel*>(this);
+    while (m_rows.count() <= v && canFetchMore(QModelIndex()))
+        that->fetchMore(QModelIndex());
+    return QModelIndexList() << index(v);
+}
+
+void setComboValues(QComboBox *combo, const QStringList &values)
+{
+    if (values.count() < 256) {
+        combo->addItems(values);
+        return;
+    }
+    ValueIndex *index = new ValueIndex(values, combo);
+    ValueModel *model = new ValueModel(index, combo);
+    model->fetchMore(QModelIndex()); // QComboBox only selects the first item if there is one
+    combo->setModel(model);
+    // whether the combo is editable is only known after all arguments were read
+    QTimer::singleShot(0, combo, [=]() {
+        if (!combo->lineEdit())
+            return;
+        ValueModel *model = new ValueModel(index, combo);
+        QCompleter *completer = new QCompleter(model, combo);
+        completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion); // the model filters
+        // not QComboBox::setCompleter(), that would map the completer rows onto the combo's model
+        combo->lineEdit()->setCompleter(completer);
+        QObject::connect(combo->lineEdit(), &QLineEdit::textEdited, model, [=](const QString &text) { model->setFilter(text); });
+    });
+}
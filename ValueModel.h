@@ -0,0 +1,69 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef QARMA_VALUEMODEL_H
+#define QARMA_VALUEMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+class QComboBox;
+
+/*  Trigram index over the values of a combo box, built in slices from the event loop so the
+    dialog shows right away. Until it's done, lookups just scan all values. */
+class ValueIndex : public QObject
+{
+public:
+    ValueIndex(const QStringList &values, QObject *parent);
+    const QStringList &values() const { return m_values; }
+    bool candidates(const QString &filter, QVector<int> *rows) const; // false: no index, scan everything
+private:
+    void build();
+    QStringList m_values;
+    QHash<quint64, QVector<int>> m_trigrams;
+    int m_indexed;
+};
+
+/*  The values matching a substring, looked up as the view asks for more rows - so typing
+    only costs as much as the popup can show. */
+class ValueModel : public QAbstractListModel
+{
+public:
+    ValueModel(const ValueIndex *index, QObject *parent);
+    void setFilter(const QString &filter);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QModelIndexList match(const QModelIndex &start, int role, const QVariant &value, int hits = 1,
+                          Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchStartsWith|Qt::MatchWrap)) const override;
+private:
+    int candidateCount() const { return m_all ? m_index->values().count() : m_candidates.count(); }
+    const ValueIndex *m_index;
+    QString m_filter;
+    QVector<int> m_candidates, m_rows;
+    bool m_all;
+    int m_scanned;
+};
+
+// small lists are just added, large ones get the lazy model and - once editable - the indexed completer
+void setComboValues(QComboBox *combo, const QStringList &values);
+
+#endif //QARMA_VALUEMODEL_H
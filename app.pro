@@ -0,0 +1,22 @@
+HEADERS = Qarma.h Dzen.h FetcherInterface.h FontPicker.h Helpers.h InputGuard.h Instrumentation.h ListSorter.h ListTree.h NotifierInterface.h Options.h TextLoader.h ValueModel.h
+SOURCES = Qarma.cpp Dzen.cpp FontPicker.cpp Helpers.cpp InputGuard.cpp Instrumentation.cpp ListSorter.cpp ListTree.cpp TextLoader.cpp ValueModel.cpp
+QT      += gui widgets
+CONFIG  += c++17
+lessThan(QT_MAJOR_VERSION, 6){
+  unix:!macx:QT += x11extras
+}
+TARGET  = qarma
+
+# override: qmake PREFIX=/some/where/else
+isEmpty(PREFIX) {
+  PREFIX = /usr
+}
+
+DEFINES += QARMA_PLUGIN_DIR=\\\"$$PREFIX/lib/qarma\\\"
+
+unix:!macx:LIBS    += -lX11
+unix:!macx:DEFINES += WS_X11
+
+target.path = $$PREFIX/bin
+
+INSTALLS += target
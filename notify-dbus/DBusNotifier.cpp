@@ -0,0 +1,89 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "DBusNotifier.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QStringList>
+
+DBusNotifier::DBusNotifier() : QObject()
+, m_inFlight(false)
+, m_queued(false)
+, m_id(0)
+, m_available(-1)
+{
+    m_message.timeout = -1;
+}
+
+bool DBusNotifier::isAvailable()
+{
+    if (m_available < 0) {
+        // the only synchronous roundtrip, once per process
+        QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+        m_available = bus && bus->isServiceRegistered("org.freedesktop.Notifications");
+    }
+    return m_available;
+}
+
+bool DBusNotifier::busy() const
+{
+    return m_inFlight || m_queued;
+}
+
+void DBusNotifier::notify(const QString &summary, const QString &body, const QVariantMap &hints, int timeout)
+{
+    m_message.summary = summary;
+    m_message.body = body;
+    m_message.hints = hints;
+    m_message.timeout = timeout;
+    m_queued = true;
+    if (!m_inFlight)
+        send();
+}
+
+void DBusNotifier::send()
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall("org.freedesktop.Notifications", "/org/freedesktop/Notifications",
+                                                      "org.freedesktop.Notifications", "Notify");
+    msg << QString("Qarma") << m_id << QString("dialog-information") << m_message.summary << m_message.body
+        << QStringList() /*actions*/ << m_message.hints << m_message.timeout;
+    emit sent();
+    m_queued = false;
+    m_inFlight = true;
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg), this);
+    connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)), SLOT(callFinished(QDBusPendingCallWatcher*)));
+}
+
+void DBusNotifier::callFinished(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<uint> reply = *watcher;
+    if (reply.isError())
+        qWarning("Notify failed: %s", qPrintable(reply.error().message()));
+    else
+        m_id = reply.value(); // so the next message replaces this one
+    watcher->deleteLater();
+    m_inFlight = false;
+    if (m_queued)
+        send();
+    else
+        emit idle();
+}
@@ -0,0 +1,60 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef DBUSNOTIFIER_H
+#define DBUSNOTIFIER_H
+
+class QDBusPendingCallWatcher;
+
+#include "NotifierInterface.h"
+
+#include <QObject>
+
+/*  org.freedesktop.Notifications client
+    Notify is sent as raw async method call (no introspecting QDBusInterface)
+    and never blocks the GUI thread. While a call is in flight, further messages
+    are coalesced into a single one that replaces the notification by its id. */
+class DBusNotifier : public QObject, public NotifierInterface
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID NotifierInterface_iid)
+    Q_INTERFACES(NotifierInterface)
+public:
+    DBusNotifier();
+    bool isAvailable() override;
+    bool busy() const override;
+    void notify(const QString &summary, const QString &body, const QVariantMap &hints, int timeout) override;
+    QObject *object() override { return this; }
+signals:
+    void sent();
+    void idle();
+private slots:
+    void callFinished(QDBusPendingCallWatcher *watcher);
+private:
+    void send();
+    struct Message {
+        QString summary, body;
+        QVariantMap hints;
+        int timeout;
+    } m_message;
+    bool m_inFlight, m_queued;
+    uint m_id;
+    int m_available;
+};
+
+#endif //DBUSNOTIFIER_H
@@ -0,0 +1,18 @@
+TEMPLATE = lib
+CONFIG  += plugin
+QT      += dbus
+QT      -= gui
+TARGET  = qarma-notify-dbus
+
+INCLUDEPATH += ..
+HEADERS = ../NotifierInterface.h DBusNotifier.h
+SOURCES = DBusNotifier.cpp
+
+# override: qmake PREFIX=/some/where/else
+isEmpty(PREFIX) {
+  PREFIX = /usr
+}
+
+target.path = $$PREFIX/lib/qarma
+
+INSTALLS += target
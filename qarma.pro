@@ -1,25 +1,19 @@
-HEADERS = Qarma.h
-SOURCES = Qarma.cpp
-QT      += gui widgets
-lessThan(QT_MAJOR_VERSION, 6){
-  unix:!macx:QT += x11extras
-}
-TARGET  = qarma
-
-DISABLE_DBUS {
-	DEFINES += QARMA_NO_DBUS
-} else {
-	QT += dbus
-}
+TEMPLATE = subdirs
 
-unix:!macx:LIBS    += -lX11
-unix:!macx:DEFINES += WS_X11
+SUBDIRS = app
+app.file = app.pro
 
-# override: qmake PREFIX=/some/where/else
-isEmpty(PREFIX) {
-  PREFIX = /usr
+# the dialogs don't need QtDBus, notify() loads the plugin on demand
+!DISABLE_DBUS {
+	SUBDIRS += notify-dbus
 }
 
-target.path = $$PREFIX/bin
+# nor QtNetwork, --text-info --url loads the fetcher
+qtHaveModule(network) {
+	SUBDIRS += url-fetch
+}
 
-INSTALLS += target
+# qmake && make check - the benchmarks and tests, headless
+qtHaveModule(testlib) {
+	SUBDIRS += tests
+}
@@ -0,0 +1,18 @@
+# time to focus of the ssh/sudo askpass prompt against the generic --password dialog, the whole app is built in
+TEMPLATE = app
+CONFIG  += testcase c++17
+QT      += testlib gui widgets
+lessThan(QT_MAJOR_VERSION, 6){
+  unix:!macx:QT += x11extras
+}
+TARGET  = tst_askpass
+
+INCLUDEPATH += ..
+DEFINES += QARMA_NO_MAIN QARMA_PLUGIN_DIR=\\\"/usr/lib/qarma\\\"
+unix:!macx:LIBS    += -lX11
+unix:!macx:DEFINES += WS_X11
+
+HEADERS = ../Qarma.h ../Dzen.h ../FetcherInterface.h ../FontPicker.h ../Helpers.h ../InputGuard.h ../Instrumentation.h ../ListSorter.h \
+          ../ListTree.h ../NotifierInterface.h ../Options.h ../TextLoader.h ../ValueModel.h
+SOURCES = tst_askpass.cpp ../Qarma.cpp ../Dzen.cpp ../FontPicker.cpp ../Helpers.cpp ../InputGuard.cpp ../Instrumentation.cpp \
+          ../ListSorter.cpp ../ListTree.cpp ../TextLoader.cpp ../ValueModel.cpp
@@ -0,0 +1,9 @@
+# QBENCHMARKs of the parsing and rendering helpers, "make check" runs them on the offscreen platform
+TEMPLATE = app
+CONFIG  += testcase c++17
+QT      += testlib widgets
+TARGET  = tst_helpers
+
+INCLUDEPATH += ..
+HEADERS = ../Helpers.h ../Instrumentation.h ../ListSorter.h
+SOURCES = tst_helpers.cpp ../Helpers.cpp ../Instrumentation.cpp ../ListSorter.cpp
@@ -0,0 +1,11 @@
+# the keyboard guard of the password entries and what an idle dialog dumps on SIGUSR1
+TEMPLATE = app
+CONFIG  += testcase c++17
+QT      += testlib widgets
+TARGET  = tst_inputguard
+
+INCLUDEPATH += ..
+unix:!macx:DEFINES += WS_X11
+
+HEADERS = ../InputGuard.h ../Instrumentation.h
+SOURCES = tst_inputguard.cpp ../InputGuard.cpp ../Instrumentation.cpp
@@ -0,0 +1,14 @@
+TEMPLATE = subdirs
+
+SUBDIRS = benchmarks
+benchmarks.file = benchmarks.pro
+
+SUBDIRS += askpass inputguard
+askpass.file = askpass.pro
+inputguard.file = inputguard.pro
+
+# against a local stand-in server, w/o QtNetwork there's no fetcher to test
+qtHaveModule(network) {
+	SUBDIRS += textloader
+	textloader.file = textloader.pro
+}
@@ -0,0 +1,9 @@
+# --text-info --url: the fetcher plugin and TextLoader against a local server, on the offscreen platform
+TEMPLATE = app
+CONFIG  += testcase c++17
+QT      += testlib network widgets
+TARGET  = tst_textloader
+
+INCLUDEPATH += .. ../url-fetch
+HEADERS = ../FetcherInterface.h ../Instrumentation.h ../TextLoader.h ../url-fetch/UrlFetcher.h
+SOURCES = tst_textloader.cpp ../Instrumentation.cpp ../TextLoader.cpp ../url-fetch/UrlFetcher.cpp
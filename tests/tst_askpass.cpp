@@ -0,0 +1,91 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "Qarma.h"
+
+#include <QElapsedTimer>
+#include <QLineEdit>
+#include <QVector>
+#include <QtTest>
+
+#include <algorithm>
+
+// the password entry has the keyboard focus, ie. the user can start typing
+static bool passwordFocused()
+{
+    const QLineEdit *le = qobject_cast<QLineEdit*>(QApplication::focusWidget());
+    return le && le->echoMode() == QLineEdit::Password && le->isActiveWindow();
+}
+
+// every run is a fresh application, from its construction until the FocusIn of the password entry
+class AskpassBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void timeToFocus_data();
+    void timeToFocus();
+};
+
+void AskpassBenchmark::timeToFocus_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::newRow("askpass") << (QStringList() << "qarma-askpass" << "Password for git@example.org:");
+    QTest::newRow("--password") << (QStringList() << "qarma" << "--password");
+}
+
+void AskpassBenchmark::timeToFocus()
+{
+    QFETCH(QStringList, arguments);
+    QVector<QByteArray> storage;
+    for (const QString &arg : arguments)
+        storage << arg.toLocal8Bit();
+
+    QVector<qint64> runs;
+    for (int run = 0; run < 9; ++run) {
+        QVector<char*> argv;
+        for (QByteArray &arg : storage)
+            argv << arg.data();
+        argv << nullptr;
+        int argc = storage.count();
+
+        QElapsedTimer timer;
+        timer.start();
+        Qarma app(argc, argv.data());
+        // not QTest::qWaitFor(), that sleeps between the polls
+        while (!passwordFocused() && timer.elapsed() < 5000)
+            QCoreApplication::processEvents();
+        const qint64 elapsed = timer.nsecsElapsed();
+        QVERIFY(passwordFocused());
+        runs << elapsed;
+        qDeleteAll(QApplication::topLevelWidgets());
+    }
+    std::sort(runs.begin(), runs.end());
+    QTest::setBenchmarkResult(runs.at(runs.count() / 2) / 1e6, QTest::WalltimeMilliseconds);
+}
+
+int main(int argc, char **argv)
+{
+    // headless, no matter where make check runs
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    // no QApplication here, every run constructs its own Qarma
+    AskpassBenchmark tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_askpass.moc"
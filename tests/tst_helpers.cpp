@@ -0,0 +1,266 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "Helpers.h"
+
+#include <QApplication>
+#include <QFileInfo>
+#include <QFont>
+#include <QImage>
+#include <QPixmap>
+#include <QTemporaryDir>
+#include <QTextEdit>
+#include <QTreeWidget>
+#include <QtTest>
+
+// synthetic input of growing size for the helpers that sit between stdin/argv and the dialogs
+class HelperBenchmark : public QObject
+{
+    Q_OBJECT
+private slots:
+    void markup_data();
+    void markup();
+    void labelCacheMiss();
+    void listValues_data();
+    void listValues();
+    void rawList_data();
+    void rawList();
+    void buildList();
+    void selectionValue();
+    void xftFont();
+    void thumbnail_data();
+    void thumbnail();
+    void progressInput_data();
+    void progressInput();
+    void textInput_data();
+    void textInput();
+private:
+    static QStringList cells(int count);
+    QTemporaryDir m_dir;
+};
+
+static void addSizes()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+QStringList HelperBenchmark::cells(int count)
+{
+    QStringList values;
+    values.reserve(count);
+    for (int i = 0; i < count; ++i)
+        values << QString::number(i * 7919 % count) + QLatin1String(" some value");
+    return values;
+}
+
+void HelperBenchmark::markup_data()
+{
+    QTest::addColumn<QString>("text");
+    const QString span("<span foreground=\"red\" font=\"Sans Bold 12\">markup &amp; <b>bold</b></span>\\n");
+    QTest::newRow("plain") << QString("just some text without any markup");
+    QTest::newRow("short") << span;
+    QTest::newRow("100 spans") << span.repeated(100);
+    QTest::newRow("10k spans") << span.repeated(10000);
+}
+
+void HelperBenchmark::markup()
+{
+    QFETCH(QString, text);
+    QString r;
+    QBENCHMARK {
+        r = pangoToRichText(text, true);
+    }
+    QVERIFY(!r.isEmpty());
+    QVERIFY(!r.contains("\\n"));
+}
+
+void HelperBenchmark::labelCacheMiss()
+{
+    // --progress labels that change with every line, "#Copying file 1234"
+    QStringList labels;
+    for (int i = 0; i < 1000; ++i)
+        labels << QString("Copying <i>file %1</i>").arg(i);
+    QBENCHMARK {
+        for (const QString &label : labels)
+            pangoToRichText(label, false);
+    }
+}
+
+void HelperBenchmark::listValues_data()
+{
+    addSizes();
+}
+
+void HelperBenchmark::listValues()
+{
+    QFETCH(int, count);
+    const QStringList values = cells(count);
+    QTreeWidget tw;
+    tw.setColumnCount(2);
+    QBENCHMARK_ONCE {
+        QStringList input = values;
+        addItems(&tw, input, false, true, false);
+    }
+    QCOMPARE(tw.topLevelItemCount(), count / 2);
+}
+
+void HelperBenchmark::rawList_data()
+{
+    addSizes();
+}
+
+void HelperBenchmark::rawList()
+{
+    QFETCH(int, count);
+    QByteArray data;
+    for (const QString &cell : cells(count))
+        data += cell.toLocal8Bit() + '\t' + cell.toLocal8Bit() + '\n';
+    QTreeWidget tw;
+    tw.setColumnCount(2);
+    qint64 consumed = 0;
+    QBENCHMARK_ONCE {
+        consumed = addItems(&tw, data.constData(), data.size(), false, true, false, false, false);
+    }
+    QCOMPARE(consumed, qint64(data.size()));
+    QCOMPARE(tw.topLevelItemCount(), count);
+}
+
+void HelperBenchmark::buildList()
+{
+    // --forms --add-list with 100k values in two columns
+    const QStringList values = cells(100000);
+    QTreeWidget list;
+    QBENCHMARK_ONCE {
+        QTreeWidget *tw = &list;
+        QStringList input = values, columns = QStringList() << "a" << "b";
+        bool showHeader = true;
+        ::buildList(&tw, input, columns, showHeader);
+        QVERIFY(!tw);
+    }
+    QCOMPARE(list.topLevelItemCount(), values.count() / 2);
+}
+
+void HelperBenchmark::selectionValue()
+{
+    QTreeWidget tw;
+    tw.setColumnCount(2);
+    tw.setSelectionMode(QAbstractItemView::MultiSelection);
+    QStringList input = cells(100000);
+    addItems(&tw, input, false, false, false);
+    tw.selectAll();
+    QString r;
+    QBENCHMARK {
+        r = value(&tw, QString());
+    }
+    QVERIFY(!r.isEmpty());
+}
+
+void HelperBenchmark::xftFont()
+{
+    QFont font;
+    QBENCHMARK {
+        font = ::xftFont("DejaVu Sans Mono-12:bold:italic:pixelsize=14");
+    }
+    QVERIFY(font.bold());
+    QCOMPARE(font.pixelSize(), 14);
+}
+
+void HelperBenchmark::thumbnail_data()
+{
+    QTest::addColumn<QString>("path");
+    QVERIFY(m_dir.isValid());
+    const QList<QSize> sizes = QList<QSize>() << QSize(640, 480) << QSize(1920, 1200) << QSize(6000, 4000);
+    for (const QSize &size : sizes) {
+        const QString path = m_dir.filePath(QString("%1x%2.png").arg(size.width()).arg(size.height()));
+        if (!QFile::exists(path)) {
+            QImage img(size, QImage::Format_RGB32);
+            img.fill(Qt::darkCyan);
+            QVERIFY(img.save(path));
+        }
+        QTest::newRow(qPrintable(QFileInfo(path).baseName())) << path;
+    }
+}
+
+void HelperBenchmark::thumbnail()
+{
+    QFETCH(QString, path);
+    QPixmap pix;
+    QBENCHMARK {
+        pix = ::thumbnail(path, 128);
+    }
+    QVERIFY(!pix.isNull());
+    QVERIFY(qMax(pix.width(), pix.height()) <= 128);
+}
+
+void HelperBenchmark::progressInput_data()
+{
+    addSizes();
+}
+
+void HelperBenchmark::progressInput()
+{
+    QFETCH(int, count);
+    QByteArray data;
+    for (int i = 0; i < count; ++i)
+        data += (i % 2 ? QByteArray("#step ") : QByteArray()) + QByteArray::number(i % 101) + " percent\n";
+    int last = -1;
+    QBENCHMARK_ONCE {
+        for (const QString &line : inputLines(QString::fromLocal8Bit(data))) {
+            if (!line.startsWith('#'))
+                last = progressValue(line);
+        }
+    }
+    QCOMPARE(last, (count - 2) % 101);
+}
+
+void HelperBenchmark::textInput_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void HelperBenchmark::textInput()
+{
+    // --text-info fed in chunks of 100 lines
+    QFETCH(int, count);
+    QString chunk;
+    for (int i = 0; i < 100; ++i)
+        chunk += QString("line %1 of some text that keeps coming\n").arg(i);
+    QTextEdit te;
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < count / 100; ++i)
+            appendText(&te, chunk);
+    }
+    QVERIFY(te.document()->blockCount() >= count);
+}
+
+int main(int argc, char **argv)
+{
+    // headless, no matter where make check runs
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    HelperBenchmark tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_helpers.moc"
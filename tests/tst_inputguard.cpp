@@ -0,0 +1,162 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "InputGuard.h"
+#include "Instrumentation.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QLineEdit>
+#include <QPalette>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#ifdef WS_X11
+#include <xcb/xcb.h>
+#endif
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+// feeds the timer events to the statistics, like Qarma::notify() does
+class TimerCounter : public QObject
+{
+protected:
+    bool eventFilter(QObject *o, QEvent *e) override {
+        if (e->type() == QEvent::Timer)
+            Stats::timerEvent(o);
+        return false;
+    }
+};
+
+class InputGuardTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void ungrabChecksAgain();
+    void otherFocusIgnored();
+    void idleDumpOnSignal();
+    void cleanupTestCase();
+private:
+#ifdef WS_X11
+    bool sendFocusIn(quint8 mode, xcb_window_t window);
+#endif
+    QLineEdit *m_entry;
+    InputGuard m_guard;
+};
+
+// a password entry that has the focus, ie. is guarded
+void InputGuardTest::initTestCase()
+{
+    QApplication::setCursorFlashTime(0); // the caret blinks by a timer, that's not what the idle test is after
+    m_entry = new QLineEdit;
+    m_entry->setEchoMode(QLineEdit::Password);
+    m_entry->installEventFilter(&m_guard);
+    m_entry->show();
+    m_entry->activateWindow();
+    m_entry->setFocus(Qt::OtherFocusReason);
+    QVERIFY(QTest::qWaitForWindowActive(m_entry));
+    QTRY_VERIFY(m_entry->hasFocus());
+}
+
+#ifdef WS_X11
+// what the xcb platform would pass on, returns whether the guard filtered it
+bool InputGuardTest::sendFocusIn(quint8 mode, xcb_window_t window)
+{
+    xcb_focus_in_event_t ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.response_type = XCB_FOCUS_IN;
+    ev.detail = XCB_NOTIFY_DETAIL_NONLINEAR;
+    ev.mode = mode;
+    ev.event = window;
+    return m_guard.nativeEventFilter("xcb_generic_event_t", &ev, nullptr);
+}
+#endif
+
+void InputGuardTest::ungrabChecksAgain()
+{
+#ifdef WS_X11
+    // check() sets a default or the red palette, depending on whether the grab works on this platform
+    const QPalette marker(Qt::green);
+    m_entry->setPalette(marker);
+    QVERIFY(!sendFocusIn(XCB_NOTIFY_MODE_UNGRAB, m_entry->window()->winId())); // Qt still gets to see it
+    QCOMPARE(m_entry->palette(), marker); // not from within the event dispatch
+    QTRY_VERIFY(m_entry->palette() != marker);
+#else
+    QSKIP("FocusIn/NotifyUngrab is X11");
+#endif
+}
+
+void InputGuardTest::otherFocusIgnored()
+{
+#ifdef WS_X11
+    const QPalette marker(Qt::green);
+    m_entry->setPalette(marker);
+    QVERIFY(!sendFocusIn(XCB_NOTIFY_MODE_NORMAL, m_entry->window()->winId()));
+    QVERIFY(!sendFocusIn(XCB_NOTIFY_MODE_UNGRAB, m_entry->window()->winId() + 1)); // somebody else's window
+    QTest::qWait(50);
+    QCOMPARE(m_entry->palette(), marker);
+#else
+    QSKIP("FocusIn/NotifyUngrab is X11");
+#endif
+}
+
+// the guard used to poll every 500 ms, a focused password entry must not wake up at all now
+void InputGuardTest::idleDumpOnSignal()
+{
+#ifdef Q_OS_UNIX
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("stats");
+    Stats::start(path);
+    listenForDumpSignal();
+    TimerCounter counter;
+    qApp->installEventFilter(&counter);
+    QTest::qWait(1200);
+    qApp->removeEventFilter(&counter);
+    QVERIFY(m_entry->hasFocus());
+
+    QVERIFY(!raise(SIGUSR1));
+    QTRY_VERIFY(QFile::exists(path));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray report = file.readAll();
+    QVERIFY2(report.contains("timer wakeups:              0 "), report.constData());
+#else
+    QSKIP("SIGUSR1 is unix");
+#endif
+}
+
+void InputGuardTest::cleanupTestCase()
+{
+    delete m_entry;
+}
+
+int main(int argc, char **argv)
+{
+    // headless, no matter where make check runs
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    InputGuardTest tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_inputguard.moc"
@@ -0,0 +1,198 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "TextLoader.h"
+#include "UrlFetcher.h"
+
+#include <QApplication>
+#include <QIODevice>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextEdit>
+#include <QUrl>
+#include <QtTest>
+
+// answers every request with the same canned response, in small pieces so the loader sees several chunks
+class StandInServer : public QTcpServer
+{
+public:
+    StandInServer(const QByteArray &contentType, const QByteArray &body) : QTcpServer(), m_body(body)
+    {
+        m_head = "HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\n";
+        if (!contentType.isEmpty())
+            m_head += "Content-Type: " + contentType + "\r\n";
+        m_head += "Connection: close\r\n\r\n";
+        connect(this, &QTcpServer::newConnection, this, [this]() {
+            QTcpSocket *socket = nextPendingConnection();
+            connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() {
+                if (!socket->readAll().contains("\r\n\r\n"))
+                    return; // not the whole request yet
+                socket->write(m_head);
+                for (int i = 0; i < m_body.size(); i += 512) {
+                    socket->write(m_body.mid(i, 512));
+                    socket->flush();
+                }
+                socket->disconnectFromHost();
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        });
+    }
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/").arg(serverPort())); }
+private:
+    QByteArray m_head, m_body;
+};
+
+class TextLoaderTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void charset_data();
+    void charset();
+    void load_data();
+    void load();
+    void failure();
+    void abort();
+private:
+    UrlFetcher m_fetcher;
+};
+
+void TextLoaderTest::charset_data()
+{
+    QTest::addColumn<QByteArray>("contentType");
+    QTest::addColumn<QByteArray>("head");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::newRow("header") << QByteArray("text/html; charset=ISO-8859-1") << QByteArray() << QByteArray("ISO-8859-1");
+    QTest::newRow("quoted header") << QByteArray("text/plain;charset=\"koi8-r\"") << QByteArray() << QByteArray("koi8-r");
+    QTest::newRow("meta charset") << QByteArray("text/html") << QByteArray("<html><head><META charset='windows-1252'>") << QByteArray("windows-1252");
+    QTest::newRow("meta http-equiv") << QByteArray("text/html")
+        << QByteArray("<meta http-equiv=\"Content-Type\" content=\"text/html; charset=iso-8859-15\">") << QByteArray("iso-8859-15");
+    QTest::newRow("none") << QByteArray("text/html") << QByteArray("<meta name=\"charsetless\" content=\"x\"><p>charset=utf-8</p>") << QByteArray();
+}
+
+void TextLoaderTest::charset()
+{
+    QFETCH(QByteArray, contentType);
+    QFETCH(QByteArray, head);
+    QFETCH(QByteArray, expected);
+    const QByteArray name = TextLoader::charset(contentType);
+    QCOMPARE(name.isEmpty() ? TextLoader::htmlCharset(head) : name, expected);
+}
+
+void TextLoaderTest::load_data()
+{
+    QTest::addColumn<QByteArray>("contentType");
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("loaded");
+    QTest::addColumn<QString>("text");
+
+    const QString greeting = QString::fromUtf8("Gr\xc3\xbc\xc3\x9f""e");
+    QByteArray latin1 = QByteArray("Gr\xfc\xdf""e ").repeated(300);
+    QTest::newRow("header charset") << QByteArray("text/plain; charset=ISO-8859-1") << latin1
+        << int(TextLoader::AutoDetect) << int(TextLoader::PlainText) << QString(greeting + ' ').repeated(300).trimmed();
+    QTest::newRow("meta charset") << QByteArray("text/html")
+        << QByteArray("<html><head><meta charset=\"iso-8859-1\"></head><body>") + latin1 + "</body></html>"
+        << int(TextLoader::AutoDetect) << int(TextLoader::RichText) << QString(greeting + ' ').repeated(300).trimmed();
+    QTest::newRow("looks like html") << QByteArray() << QByteArray("<b>bold</b> and <i>italic</i>")
+        << int(TextLoader::AutoDetect) << int(TextLoader::RichText) << QString("bold and italic");
+    QTest::newRow("plain text") << QByteArray("text/plain") << QByteArray("plain & simple")
+        << int(TextLoader::AutoDetect) << int(TextLoader::PlainText) << QString("plain & simple");
+    QTest::newRow("--plain") << QByteArray("text/html") << QByteArray("<b>bold</b>")
+        << int(TextLoader::PlainText) << int(TextLoader::PlainText) << QString("<b>bold</b>");
+}
+
+void TextLoaderTest::load()
+{
+    QFETCH(QByteArray, contentType);
+    QFETCH(QByteArray, body);
+    QFETCH(int, format);
+    QFETCH(int, loaded);
+    QFETCH(QString, text);
+
+    StandInServer server(contentType, body);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QTextEdit te;
+    QIODevice *reply = m_fetcher.get(server.url(), &te);
+    TextLoader *loader = new TextLoader(reply, &te, TextLoader::Format(format), [&]() { return m_fetcher.contentType(reply); });
+    QSignalSpy progress(loader, &TextLoader::progress);
+    QSignalSpy finished(loader, &TextLoader::finished);
+    m_fetcher.onProgress(reply, loader, [=](qint64 received, qint64 total) { loader->sourceProgress(received, total); });
+    QVERIFY(finished.wait(5000));
+    QVERIFY(!m_fetcher.failed(reply));
+    QCOMPARE(int(loader->format()), loaded);
+    QCOMPARE(te.toPlainText().trimmed(), text);
+    QVERIFY(!progress.isEmpty());
+    QCOMPARE(progress.last().at(0).toInt(), 1000);
+}
+
+void TextLoaderTest::failure()
+{
+    // nobody listens there (anymore)
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    const QUrl url(QString("http://127.0.0.1:%1/").arg(server.serverPort()));
+    server.close();
+    QTextEdit te;
+    QIODevice *reply = m_fetcher.get(url, &te);
+    TextLoader *loader = new TextLoader(reply, &te, TextLoader::AutoDetect);
+    QSignalSpy finished(loader, &TextLoader::finished);
+    QVERIFY(finished.wait(5000));
+    QVERIFY(m_fetcher.failed(reply));
+    QVERIFY(te.toPlainText().isEmpty());
+}
+
+void TextLoaderTest::abort()
+{
+    // promises more than it sends and keeps the connection open
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    QObject::connect(&server, &QTcpServer::newConnection, &server, [&server]() {
+        QTcpSocket *socket = server.nextPendingConnection();
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            if (socket->readAll().contains("\r\n\r\n"))
+                socket->write("HTTP/1.1 200 OK\r\nContent-Length: 100000\r\nContent-Type: text/plain\r\n\r\nthe first part");
+        });
+    });
+    QTextEdit te;
+    QIODevice *reply = m_fetcher.get(QUrl(QString("http://127.0.0.1:%1/").arg(server.serverPort())), &te);
+    TextLoader *loader = new TextLoader(reply, &te, TextLoader::AutoDetect, [&]() { return m_fetcher.contentType(reply); });
+    QSignalSpy progress(loader, &TextLoader::progress);
+    QSignalSpy finished(loader, &TextLoader::finished);
+    m_fetcher.onProgress(reply, loader, [=](qint64 received, qint64 total) { loader->sourceProgress(received, total); });
+    QVERIFY(progress.wait(5000));
+    loader->abort();
+    m_fetcher.abort(reply);
+    QCOMPARE(finished.count(), 1);
+    QVERIFY(!m_fetcher.failed(reply));
+    QTest::qWait(50);
+    QCOMPARE(finished.count(), 1); // not again for the reply's own end
+    QCOMPARE(te.toPlainText(), QString("the first part"));
+}
+
+int main(int argc, char **argv)
+{
+    // headless, no matter where make check runs
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    TextLoaderTest tc;
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "tst_textloader.moc"
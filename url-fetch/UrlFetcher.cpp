@@ -0,0 +1,63 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "UrlFetcher.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrl>
+
+UrlFetcher::UrlFetcher() : QObject()
+, m_manager(new QNetworkAccessManager(this))
+{
+}
+
+QIODevice *UrlFetcher::get(const QUrl &url, QObject *parent)
+{
+    QNetworkRequest request(url);
+    // like curl -L did, but not from https to http
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    QNetworkReply *reply = m_manager->get(request);
+    reply->setParent(parent);
+    return reply;
+}
+
+QByteArray UrlFetcher::contentType(const QIODevice *reply) const
+{
+    const QNetworkReply *r = qobject_cast<const QNetworkReply*>(reply);
+    return r ? r->rawHeader("Content-Type") : QByteArray();
+}
+
+bool UrlFetcher::failed(const QIODevice *reply) const
+{
+    const QNetworkReply *r = qobject_cast<const QNetworkReply*>(reply);
+    return r && r->error() != QNetworkReply::NoError && r->error() != QNetworkReply::OperationCanceledError;
+}
+
+void UrlFetcher::abort(QIODevice *reply)
+{
+    if (QNetworkReply *r = qobject_cast<QNetworkReply*>(reply))
+        r->abort();
+}
+
+void UrlFetcher::onProgress(QIODevice *reply, QObject *context, const std::function<void(qint64, qint64)> &progress)
+{
+    if (QNetworkReply *r = qobject_cast<QNetworkReply*>(reply))
+        connect(r, &QNetworkReply::downloadProgress, context, progress);
+}
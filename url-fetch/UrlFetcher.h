@@ -0,0 +1,45 @@
+/*
+ *   Qarma - a Zenity clone for Qt4 and Qt5
+ *   Copyright 2014 by Thomas Lübking <thomas.luebking@gmail.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details
+ *
+ *   You should have received a copy of the GNU General Public
+ *   License along with this program; if not, write to the
+ *   Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef URLFETCHER_H
+#define URLFETCHER_H
+
+class QNetworkAccessManager;
+
+#include "FetcherInterface.h"
+
+#include <QObject>
+
+/*  Plain GET requests through one QNetworkAccessManager, the reply belongs to whoever asked for it */
+class UrlFetcher : public QObject, public FetcherInterface
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID FetcherInterface_iid)
+    Q_INTERFACES(FetcherInterface)
+public:
+    UrlFetcher();
+    QIODevice *get(const QUrl &url, QObject *parent) override;
+    QByteArray contentType(const QIODevice *reply) const override;
+    bool failed(const QIODevice *reply) const override;
+    void abort(QIODevice *reply) override;
+    void onProgress(QIODevice *reply, QObject *context, const std::function<void(qint64, qint64)> &progress) override;
+private:
+    QNetworkAccessManager *m_manager;
+};
+
+#endif //URLFETCHER_H
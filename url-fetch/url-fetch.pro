@@ -0,0 +1,18 @@
+TEMPLATE = lib
+CONFIG  += plugin
+QT      += network
+QT      -= gui
+TARGET  = qarma-url-fetch
+
+INCLUDEPATH += ..
+HEADERS = ../FetcherInterface.h UrlFetcher.h
+SOURCES = UrlFetcher.cpp
+
+# override: qmake PREFIX=/some/where/else
+isEmpty(PREFIX) {
+  PREFIX = /usr
+}
+
+target.path = $$PREFIX/lib/qarma
+
+INSTALLS += target